@@ -1,6 +1,11 @@
 #include "box2d/impl/collider_box2d.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
 #include "core/ark.h"
+#include "core/inf/executor.h"
 #include "core/impl/variable/variable_wrapper.h"
 #include "core/util/boolean_type.h"
 
@@ -10,6 +15,7 @@
 
 #include "renderer/base/resource_loader_context.h"
 
+#include "app/base/application_context.h"
 #include "app/base/collision_manifold.h"
 #include "app/base/raycast_manifold.h"
 #include "app/inf/collision_callback.h"
@@ -24,8 +30,66 @@
 
 namespace ark::plugin::box2d {
 
-ColliderBox2D::ColliderBox2D(const b2Vec2& gravity, const V2& pixelPerMeter)
-    : _stub(sp<Stub>::make(gravity, pixelPerMeter))
+namespace {
+
+//  Box2D's B2_MAX_WORKERS, which isn't public. Worker indices past it would overrun the world's per-worker contexts.
+constexpr uint32_t BOX2D_MAX_WORKERS = 64;
+
+//  A Box2D task split into at most "workerCount" ranges. A range's index doubles as its worker index, which is what Box2D v3's b2TaskCallback contract asks for:
+//  the index must be in [0, workerCount) and identify a worker that runs on only one thread at a time. Ranges never outnumber "workerCount" and each one runs exactly once,
+//  so no two threads of a task hold the same index. Box2D keys its per-worker scratch (b2World::taskContexts) by it, and the tasks it keeps running concurrently,
+//  the solver's per-worker b2SolverTask, take their worker index from the task context instead and don't share scratch through this one.
+//  The thread finishing the task runs the ranges nobody has picked up yet. Box2D's solver workers spin until worker 0 is done,
+//  so worker 0 must not wait in the executor's queue behind them.
+struct Box2DTask {
+    Box2DTask(b2TaskCallback* callback, const int32_t itemCount, const int32_t minRange, void* taskContext, const uint32_t workerCount)
+        : _callback(callback), _task_context(taskContext), _item_count(itemCount), _range_size(std::max(std::max(minRange, 1), (itemCount + static_cast<int32_t>(workerCount) - 1) / static_cast<int32_t>(workerCount))),
+          _range_count(itemCount > 0 ? static_cast<uint32_t>((itemCount + _range_size - 1) / _range_size) : 0), _next_range(0), _finished_ranges(0) {
+        DASSERT(_range_count <= workerCount);
+    }
+
+    void runRanges() {
+        for(uint32_t range = _next_range.fetch_add(1, std::memory_order_relaxed); range < _range_count; range = _next_range.fetch_add(1, std::memory_order_relaxed)) {
+            const int32_t begin = static_cast<int32_t>(range) * _range_size;
+            _callback(begin, std::min(begin + _range_size, _item_count), range, _task_context);
+            if(_finished_ranges.fetch_add(1, std::memory_order_acq_rel) + 1 == _range_count)
+                _finished_ranges.notify_all();
+        }
+    }
+
+    void waitForAll() {
+        for(uint32_t finished = _finished_ranges.load(std::memory_order_acquire); finished < _range_count; finished = _finished_ranges.load(std::memory_order_acquire))
+            _finished_ranges.wait(finished, std::memory_order_acquire);
+    }
+
+    b2TaskCallback* _callback;
+    void* _task_context;
+    int32_t _item_count;
+    int32_t _range_size;
+    uint32_t _range_count;
+
+    std::atomic<uint32_t> _next_range;
+    std::atomic<uint32_t> _finished_ranges;
+};
+
+class Box2DTaskRunner final : public Runnable {
+public:
+    Box2DTaskRunner(sp<Box2DTask> task)
+        : _task(std::move(task)) {
+    }
+
+    void run() override {
+        _task->runRanges();
+    }
+
+private:
+    sp<Box2DTask> _task;
+};
+
+}
+
+ColliderBox2D::ColliderBox2D(const b2Vec2& gravity, const V2& pixelPerMeter, const uint32_t workerCount)
+    : _stub(sp<Stub>::make(gravity, pixelPerMeter, workerCount))
 {
     const BodyCreateInfo box(sp<Box>::make(), 1.0f, 0.2f);
     _stub->_body_manifests[ark::Shape::TYPE_AABB] = box;
@@ -149,6 +213,43 @@ int32_t ColliderBox2D::bodyCount() const
     return b2World_GetAwakeBodyCount(_stub->_world_id);
 }
 
+b2Transform ColliderBox2D::getInterpolatedTransform(const b2BodyId body) const
+{
+    const Stub::BodyTransform* bodyTransform = _stub->findBodyTransform(body);
+    if(!bodyTransform)
+        return b2Body_GetTransform(body);
+    if(bodyTransform->_moved_step != _stub->_step_count)
+    {
+#if ARK_FLAG_BUILD_TYPE == 1
+        const b2Transform actual = b2Body_GetTransform(body);
+        const b2Transform& cached = bodyTransform->_current;
+        DCHECK(actual.p.x == cached.p.x && actual.p.y == cached.p.y && actual.q.c == cached.q.c && actual.q.s == cached.q.s,
+               "Body moved without a move event, b2Body_SetTransform must be followed by ColliderBox2D::syncTransform");
+#endif
+        return bodyTransform->_current;
+    }
+
+    const float alpha = _stub->_accumulator / _stub->_time_step;
+    const b2Transform& previous = bodyTransform->_previous;
+    const b2Transform& current = bodyTransform->_current;
+    return {b2Lerp(previous.p, current.p, alpha), b2NLerp(previous.q, current.q, alpha)};
+}
+
+bool ColliderBox2D::isMoving(const b2BodyId body) const
+{
+    const Stub::BodyTransform* bodyTransform = _stub->findBodyTransform(body);
+    return !bodyTransform || bodyTransform->_moved_step == _stub->_step_count;
+}
+
+void ColliderBox2D::syncTransform(const b2BodyId body) const
+{
+    const b2Transform transform = b2Body_GetTransform(body);
+    Stub::BodyTransform& bodyTransform = _stub->ensureBodyTransform(body, transform);
+    bodyTransform._previous = transform;
+    bodyTransform._current = transform;
+    bodyTransform._moved_step = _stub->_step_count;
+}
+
 void ColliderBox2D::track(const sp<Joint::Stub>& /*joint*/) const
 {
 }
@@ -161,8 +262,11 @@ void ColliderBox2D::setBodyManifest(int32_t id, const BodyCreateInfo& bodyManife
 
 ColliderBox2D::BUILDER_IMPL1::BUILDER_IMPL1(BeanFactory& factory, const document& manifest, const sp<ResourceLoaderContext>& resourceLoaderContext)
     : _factory(factory), _manifest(manifest), _resource_loader_context(resourceLoaderContext), _ppm(Documents::ensureAttribute<V2>(manifest, "pixel-per-meter")),
-      _gravity(Documents::getAttribute<V2>(manifest, "gravity", {0, -9.8f})), _discarded(factory.getBuilder<Boolean>(manifest, constants::DISCARDED))
+      _gravity(Documents::getAttribute<V2>(manifest, "gravity", {0, -9.8f})), _discarded(factory.getBuilder<Boolean>(manifest, constants::DISCARDED)),
+      _time_step(Documents::getAttribute<float>(manifest, "time-step", 1.0f / 60.0f)), _sub_step_count(Documents::getAttribute<int32_t>(manifest, "sub-step-count", 4)),
+      _worker_count(Documents::getAttribute<uint32_t>(manifest, "worker-count", 0))
 {
+    CHECK(_time_step > 0, "Illegal time-step: %.4f", _time_step);
     for(const document& i : _manifest->children("import"))
         _importers.push_back({_factory.ensureBuilder<RigidBodyImporter>(i), Documents::ensureAttribute(i, constants::SRC)});
 }
@@ -170,7 +274,9 @@ ColliderBox2D::BUILDER_IMPL1::BUILDER_IMPL1(BeanFactory& factory, const document
 sp<ColliderBox2D> ColliderBox2D::BUILDER_IMPL1::build(const Scope& args)
 {
     b2Vec2 gravity(_gravity.x(), _gravity.y());
-    const sp<ColliderBox2D> world = sp<ColliderBox2D>::make(gravity, _ppm);
+    const sp<ColliderBox2D> world = sp<ColliderBox2D>::make(gravity, _ppm, _worker_count);
+    world->_stub->_time_step = _time_step;
+    world->_stub->_sub_step_count = _sub_step_count;
     for(const document& i : _manifest->children("rigid-body"))
     {
         const int32_t type = Documents::ensureAttribute<int32_t>(i, constants::TYPE);
@@ -204,10 +310,18 @@ sp<Collider> ColliderBox2D::BUILDER_IMPL2::build(const Scope& args)
     return _delegate.build(args);
 }
 
-ColliderBox2D::Stub::Stub(const b2Vec2& gravity, const V2& pixelPerMeter)
-    : _ppm_x(pixelPerMeter.x()), _ppm_y(pixelPerMeter.y()), _time_step(1.0f / 60.0f), _sub_step_count(4), _world_def(b2DefaultWorldDef())
+ColliderBox2D::Stub::Stub(const b2Vec2& gravity, const V2& pixelPerMeter, const uint32_t workerCount)
+    : _ppm_x(pixelPerMeter.x()), _ppm_y(pixelPerMeter.y()), _time_step(1.0f / 60.0f), _sub_step_count(4), _accumulator(0), _step_count(0), _world_def(b2DefaultWorldDef())
 {
     _world_def.gravity = gravity;
+    if(workerCount > 1)
+    {
+        _executor = Ark::instance().applicationContext()->threadPoolExecutor();
+        _world_def.workerCount = static_cast<int32_t>(std::min(workerCount, BOX2D_MAX_WORKERS));
+        _world_def.enqueueTask = enqueueTask;
+        _world_def.finishTask = finishTask;
+        _world_def.userTaskContext = this;
+    }
     _world_id = b2CreateWorld(&_world_def);
 }
 
@@ -262,8 +376,33 @@ void ColliderBox2D::onEndContact(const b2ContactEndTouchEvent& event)
 }
 
 void ColliderBox2D::Stub::run()
+{
+//  The app clock is looked up every frame, since clocks get pushed and popped after this collider got created.
+//  Frames longer than a few steps are dropped rather than caught up with, or a slow frame would make the next one slower.
+    const float interval = Ark::instance().applicationContext()->appClockInterval()->val();
+    _accumulator = std::min(_accumulator + interval, _time_step * 4);
+    while(_accumulator >= _time_step)
+    {
+        step();
+        _accumulator -= _time_step;
+    }
+}
+
+void ColliderBox2D::Stub::step()
 {
     b2World_Step(_world_id, _time_step, _sub_step_count);
+    ++ _step_count;
+
+//  Only awake bodies that moved are reported, sleeping ones keep their cached transforms and cost nothing per frame.
+    const b2BodyEvents bodyEvents = b2World_GetBodyEvents(_world_id);
+    for(int32_t i = 0; i < bodyEvents.moveCount; ++i)
+    {
+        const b2BodyMoveEvent& event = bodyEvents.moveEvents[i];
+        BodyTransform& bodyTransform = ensureBodyTransform(event.bodyId, event.transform);
+        bodyTransform._previous = bodyTransform._current;
+        bodyTransform._current = event.transform;
+        bodyTransform._moved_step = _step_count;
+    }
     const b2ContactEvents contactEvents = b2World_GetContactEvents(_world_id);
     for(int32_t i = 0; i < contactEvents.beginCount; ++i)
         onBeginContact(contactEvents.beginEvents[i]);
@@ -271,5 +410,45 @@ void ColliderBox2D::Stub::run()
         onEndContact(contactEvents.endEvents[i]);
 }
 
+const ColliderBox2D::Stub::BodyTransform* ColliderBox2D::Stub::findBodyTransform(const b2BodyId bodyId) const
+{
+    const size_t index = static_cast<size_t>(bodyId.index1 - 1);
+    if(index >= _body_transforms.size() || _body_transforms[index]._generation != static_cast<int32_t>(bodyId.generation))
+        return nullptr;
+    return &_body_transforms[index];
+}
+
+ColliderBox2D::Stub::BodyTransform& ColliderBox2D::Stub::ensureBodyTransform(const b2BodyId bodyId, const b2Transform& transform)
+{
+    const size_t index = static_cast<size_t>(bodyId.index1 - 1);
+    if(index >= _body_transforms.size())
+        _body_transforms.resize(index + 1, {b2Transform_identity, b2Transform_identity, -1, 0});
+
+//  The cache only stays in sync with Box2D as long as every body moves either in b2World_Step, which raises a move event,
+//  or through b2Body_SetTransform followed by syncTransform. RigidbodyBox2D is the only caller of b2Body_SetTransform and keeps to that,
+//  anything else teleporting bodies has to as well. getInterpolatedTransform checks it in debug builds.
+//  A body whose index got reused starts over, with no previous transform to interpolate from.
+    BodyTransform& bodyTransform = _body_transforms[index];
+    if(bodyTransform._generation != static_cast<int32_t>(bodyId.generation))
+        bodyTransform = {transform, transform, static_cast<int32_t>(bodyId.generation), 0};
+    return bodyTransform;
+}
+
+void* ColliderBox2D::Stub::enqueueTask(b2TaskCallback* task, const int32_t itemCount, const int32_t minRange, void* taskContext, void* userContext)
+{
+    const Stub* self = static_cast<const Stub*>(userContext);
+    sp<Box2DTask> userTask = sp<Box2DTask>::make(task, itemCount, minRange, taskContext, static_cast<uint32_t>(self->_world_def.workerCount));
+    for(uint32_t i = 0; i < userTask->_range_count; ++i)
+        self->_executor->execute(sp<Runnable>::make<Box2DTaskRunner>(userTask));
+    return new sp<Box2DTask>(std::move(userTask));
+}
+
+void ColliderBox2D::Stub::finishTask(void* userTask, void* /*userContext*/)
+{
+    const std::unique_ptr<sp<Box2DTask>> task(static_cast<sp<Box2DTask>*>(userTask));
+    (*task)->runRanges();
+    (*task)->waitForAll();
+}
+
 
 }
@@ -26,7 +26,7 @@ public:
     typedef Importer<ColliderBox2D> RigidBodyImporter;
 
 public:
-    ColliderBox2D(const b2Vec2& gravity, const V2& pixelPerMeter);
+    ColliderBox2D(const b2Vec2& gravity, const V2& pixelPerMeter, uint32_t workerCount = 0);
     DEFAULT_COPY_AND_ASSIGN(ColliderBox2D);
 
     void run() override;
@@ -49,6 +49,15 @@ public:
 
     int32_t bodyCount() const;
 
+//  Transform of "body" one time step behind the render time, so bodies move smoothly when the frame rate and the fixed time step don't match.
+//  Read from the transform cache which is filled by Box2D's move events after each step, bodies not in it are queried from Box2D.
+    b2Transform getInterpolatedTransform(b2BodyId body) const;
+//  True if "body" moved in the latest step or got teleported since, its interpolated transform changes every frame until the next step without it.
+    bool isMoving(b2BodyId body) const;
+//  Refreshes the cached transform of "body", which is needed after b2Body_SetTransform because it doesn't raise a move event.
+//  Every b2Body_SetTransform call must be followed by it, or interpolation keeps reading the transform from before the teleport.
+    void syncTransform(b2BodyId body) const;
+
     void track(const sp<Joint::Stub>& joint) const;
 
 //  [[plugin::resource-loader]]
@@ -71,6 +80,10 @@ public:
         V2 _ppm;
         V2 _gravity;
         SafeBuilder<Boolean> _discarded;
+
+        float _time_step;
+        int32_t _sub_step_count;
+        uint32_t _worker_count;
     };
 
 //  [[plugin::resource-loader("b2World")]]
@@ -89,21 +102,45 @@ public:
 private:
 
     struct Stub final : Runnable {
-        Stub(const b2Vec2& gravity, const V2& pixelPerMeter);
+        Stub(const b2Vec2& gravity, const V2& pixelPerMeter, uint32_t workerCount);
         ~Stub() override;
 
+//  Steps the world on a fixed time step, as many times as the app clock has advanced by since the last call.
         void run() override;
 
+        void step();
+
+        struct BodyTransform {
+            b2Transform _previous;
+            b2Transform _current;
+//  -1 for indices no body has been cached at.
+            int32_t _generation;
+            uint32_t _moved_step;
+        };
+
+        const BodyTransform* findBodyTransform(b2BodyId bodyId) const;
+        BodyTransform& ensureBodyTransform(b2BodyId bodyId, const b2Transform& transform);
+
+        static void* enqueueTask(b2TaskCallback* task, int32_t itemCount, int32_t minRange, void* taskContext, void* userContext);
+        static void finishTask(void* userTask, void* userContext);
+
         float _ppm_x;
         float _ppm_y;
 
         float _time_step;
         int32_t _sub_step_count;
 
+        float _accumulator;
+        uint32_t _step_count;
+
+        sp<Executor> _executor;
+
         b2WorldDef _world_def;
         b2WorldId _world_id;
         HashMap<HashId, BodyCreateInfo> _body_manifests;
 
+//  Indexed by b2BodyId::index1 - 1, which Box2D keeps dense by reusing the indices of destroyed bodies.
+        Vector<BodyTransform> _body_transforms;
     };
 
 private:
@@ -21,41 +21,70 @@ namespace ark::plugin::box2d {
 
 namespace {
 
+//  Reads the collider's transform cache. The transform changes every frame while the body moves, and once more when it comes to rest.
+class BodyTransformTracker {
+public:
+    BodyTransformTracker(sp<RigidbodyBox2D::Stub> stub)
+        : _stub(std::move(stub)), _tick(0), _moving(true), _dirty(true) {
+    }
+
+    b2Transform transform() const {
+        DCHECK(b2Body_IsValid(_stub->_body), "Body has been disposed already");
+        return _stub->_world.getInterpolatedTransform(_stub->_body);
+    }
+
+    bool update(const uint32_t tick) {
+        if(_tick != tick)
+        {
+            _tick = tick;
+            const bool moving = _stub->_world.isMoving(_stub->_body);
+            _dirty = moving || _moving;
+            _moving = moving;
+        }
+        return _dirty;
+    }
+
+    sp<RigidbodyBox2D::Stub> _stub;
+
+private:
+    uint32_t _tick;
+    bool _moving;
+    bool _dirty;
+};
+
 class _RigidBodyRotation final : public Numeric {
 public:
     _RigidBodyRotation(const sp<RigidbodyBox2D::Stub>& stub)
-        : _stub(stub) {
+        : _tracker(stub) {
     }
 
     float val() override {
-        DCHECK(b2Body_IsValid(_stub->_body), "Body has been disposed already");
-        return b2Rot_GetAngle(b2Body_GetTransform(_stub->_body).q);
+        return b2Rot_GetAngle(_tracker.transform().q);
     }
 
-    bool update(uint32_t /*tick*/) override {
-        return true;
+    bool update(uint32_t tick) override {
+        return _tracker.update(tick);
     }
 
-    sp<RigidbodyBox2D::Stub> _stub;
+    BodyTransformTracker _tracker;
 };
 
 class _RigidBodyPosition : public Vec3 {
 public:
     _RigidBodyPosition(const sp<RigidbodyBox2D::Stub>& stub, const sp<Vec3>& delegate)
-        : _stub(stub)/*, _delegate(delegate)*/ {
+        : _tracker(stub)/*, _delegate(delegate)*/ {
     }
 
     V3 val() override {
-        DCHECK(b2Body_IsValid(_stub->_body), "Body has been disposed already");
-        const b2Transform transform = b2Body_GetTransform(_stub->_body);
+        const b2Transform transform = _tracker.transform();
         return {transform.p.x, transform.p.y, 0};
     }
 
-    bool update(uint32_t /*tick*/) override {
-        return true;
+    bool update(uint32_t tick) override {
+        return _tracker.update(tick);
     }
 
-    sp<RigidbodyBox2D::Stub> _stub;
+    BodyTransformTracker _tracker;
     sp<Vec3> _delegate;
 
 };
@@ -63,23 +92,21 @@ public:
 class RenderObjectPosition : public Vec3 {
 public:
     RenderObjectPosition(const sp<RigidbodyBox2D::Stub>& stub)
-        : _stub(stub) {
+        : _tracker(stub) {
     }
 
     V3 val() override {
-        DCHECK(b2Body_IsValid(_stub->_body), "Body has been disposed already");
-        const b2Transform transform = b2Body_GetTransform(_stub->_body);
-        const float x = _stub->_world.toPixelX(transform.p.x);
-        const float y = _stub->_world.toPixelY(transform.p.y);
-        return {x, y, 0};
+        const b2Transform transform = _tracker.transform();
+        const ColliderBox2D& world = _tracker._stub->_world;
+        return {world.toPixelX(transform.p.x), world.toPixelY(transform.p.y), 0};
     }
 
-    bool update(uint32_t /*tick*/) override {
-        return true;
+    bool update(uint32_t tick) override {
+        return _tracker.update(tick);
     }
 
 private:
-    sp<RigidbodyBox2D::Stub> _stub;
+    BodyTransformTracker _tracker;
 };
 
 class ManualLinearVelocity : public Runnable {
@@ -168,6 +195,7 @@ RigidbodyBox2D::RigidbodyBox2D(const sp<Stub>& stub, Rigidbody::BodyType type, c
       _box2d_stub(stub)
 {
     b2Body_SetUserData(_box2d_stub->_body, this);
+    _box2d_stub->_world.syncTransform(_box2d_stub->_body);
 }
 
 const sp<Rigidbody::Stub>& RigidbodyBox2D::stub() const
@@ -189,17 +217,20 @@ void RigidbodyBox2D::setAngle(float rad)
 {
     const b2Vec2 pos = b2Body_GetPosition(_box2d_stub->body());
     b2Body_SetTransform(_box2d_stub->body(), pos, b2MakeRot(rad));
+    _box2d_stub->_world.syncTransform(_box2d_stub->body());
 }
 
 V3 RigidbodyBox2D::position() const
 {
-    return _stub->_position.val();
+    const b2Vec2 position = b2Body_GetPosition(_box2d_stub->body());
+    return {position.x, position.y, 0};
 }
 
 void RigidbodyBox2D::setPosition(const V3& position)
 {
     const b2Rot rot = b2Body_GetTransform(_box2d_stub->body()).q;
     b2Body_SetTransform(_box2d_stub->body(), {position.x(), position.y()}, rot);
+    _box2d_stub->_world.syncTransform(_box2d_stub->body());
 }
 
 V3 RigidbodyBox2D::centralForce() const
@@ -333,6 +364,7 @@ void RigidbodyBox2D::applyAngularImpulse(float impulse, bool wake)
 void RigidbodyBox2D::setTransform(const V2& position, float angle)
 {
     b2Body_SetTransform(_box2d_stub->_body, {position.x(), position.y()}, b2MakeRot(angle));
+    _box2d_stub->_world.syncTransform(_box2d_stub->_body);
 }
 
 sp<Future> RigidbodyBox2D::applyLinearVelocity(const sp<Vec2>& velocity)
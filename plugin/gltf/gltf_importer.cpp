@@ -411,6 +411,15 @@ Animation loadAnimation(const tinygltf::Model& model, const tinygltf::Animation&
 					FATAL("Unknown type %d", accessor.type);
 					break;
 			}
+
+			// Cubic spline outputs are in-tangent, value, out-tangent triplets, only the values are kept
+			if(sampler.interpolation == AnimationSampler::InterpolationType::CUBICSPLINE)
+			{
+				Vector<V4> values;
+				for(size_t index = 1; index < sampler.outputsVec4.size(); index += 3)
+					values.push_back(sampler.outputsVec4.at(index));
+				sampler.outputsVec4 = std::move(values);
+			}
 		}
 
 		animation.samplers.push_back(sampler);
@@ -437,6 +446,70 @@ Animation loadAnimation(const tinygltf::Model& model, const tinygltf::Animation&
 	return animation;
 }
 
+Map<uint32_t, M4> loadInverseBindMatrices(const tinygltf::Model& model)
+{
+	Map<uint32_t, M4> inverseBindMatrices;
+	for(const tinygltf::Skin& i : model.skins)
+	{
+		if(i.inverseBindMatrices < 0)
+			continue;
+
+		const tinygltf::Accessor& accessor = model.accessors[i.inverseBindMatrices];
+		const tinygltf::BufferView& bufferView = model.bufferViews[accessor.bufferView];
+		const tinygltf::Buffer& buffer = model.buffers[bufferView.buffer];
+		CHECK(accessor.componentType == TINYGLTF_COMPONENT_TYPE_FLOAT && accessor.type == TINYGLTF_TYPE_MAT4 && accessor.count >= i.joints.size(), "Illegal inverse bind matrices in skin \"%s\"", i.name.c_str());
+
+		Vector<M4> matrices(accessor.count);
+		memcpy(matrices.data(), &buffer.data[accessor.byteOffset + bufferView.byteOffset], accessor.count * sizeof(M4));
+		for(size_t j = 0; j < i.joints.size(); ++j)
+			inverseBindMatrices.emplace(static_cast<uint32_t>(i.joints.at(j)), matrices.at(j));
+	}
+	return inverseBindMatrices;
+}
+
+Vector<ark::Animation::NodeTracks> makeNodeTracks(const Animation& animation, const Vector<sp<Node>>& nodes, const Map<uint32_t, uint32_t>& channelNodeIds, const Map<uint32_t, M4>& inverseBindMatrices)
+{
+	Vector<uint32_t> nodeIds(channelNodeIds.size());
+	for(const auto& [k, v] : channelNodeIds)
+		nodeIds[v] = k;
+
+	Vector<ark::Animation::NodeTracks> nodeTracks;
+	nodeTracks.reserve(nodeIds.size());
+	for(const uint32_t i : nodeIds)
+	{
+		const sp<Node>& node = nodes.at(i);
+		const auto iter = inverseBindMatrices.find(i);
+		nodeTracks.push_back({MatrixUtil::inverse(node->localMatrix()),
+		                      {ark::Animation::INTERPOLATION_STEP, {0.0f}, {V4(node->translation(), 1.0f)}, false},
+		                      {ark::Animation::INTERPOLATION_STEP, {0.0f}, {node->rotation()}, true},
+		                      {ark::Animation::INTERPOLATION_STEP, {0.0f}, {V4(node->scale(), 1.0f)}, false},
+		                      iter != inverseBindMatrices.end() ? iter->second : M4::identity()});
+	}
+
+	for(const AnimationChannel& i : animation.channels)
+	{
+		const AnimationSampler& sampler = animation.samplers.at(i.samplerIndex);
+		if(sampler.inputs.empty() || sampler.inputs.size() > sampler.outputsVec4.size())
+			continue;
+
+		ark::Animation::NodeTracks& tracks = nodeTracks.at(channelNodeIds.at(i.node_id));
+		const ark::Animation::Interpolation interpolation = sampler.interpolation == AnimationSampler::InterpolationType::STEP ? ark::Animation::INTERPOLATION_STEP : ark::Animation::INTERPOLATION_LINEAR;
+		switch(i.path) {
+			case AnimationChannel::PathType::TRANSLATION:
+				tracks._translation = {interpolation, sampler.inputs, sampler.outputsVec4, false};
+				break;
+			case AnimationChannel::PathType::SCALE:
+				tracks._scale = {interpolation, sampler.inputs, sampler.outputsVec4, false};
+				break;
+			case AnimationChannel::PathType::ROTATION:
+				tracks._rotation = {interpolation, sampler.inputs, sampler.outputsVec4, true};
+				break;
+		}
+	}
+	return nodeTracks;
+}
+
+#if ARK_FLAG_BUILD_TYPE == 1
 void updateAnimation(Animation& animation, Vector<NodeTransform>& nodeTransforms, const Map<uint32_t, uint32_t>& channelNodeIds, float time)
 {
 	for(AnimationChannel& i : animation.channels)
@@ -475,6 +548,32 @@ void initNodeTransforms(const Vector<sp<Node>>& nodes, Vector<NodeTransform>& no
 	}
 }
 
+// Compares the keyframe tracks with the per-tick matrices the unquantized channels bake into
+void reportAnimation(Animation& animation, const ark::Animation& anim, const Vector<sp<Node>>& nodes, const Map<uint32_t, uint32_t>& channelNodeIds)
+{
+	Vector<NodeTransform> nodeTransforms(channelNodeIds.size());
+	initNodeTransforms(nodes, nodeTransforms, channelNodeIds);
+
+	float maxError = 0;
+	AnimationFrame frame;
+	const uint32_t tickCount = anim.ticks();
+	for(uint32_t i = 0; i < tickCount; ++i)
+	{
+		updateAnimation(animation, nodeTransforms, channelNodeIds, static_cast<float>(i) / anim.tps());
+		anim.sample(static_cast<float>(i), frame);
+		for(size_t j = 0; j < nodeTransforms.size(); ++j)
+		{
+			const M4 baked = nodeTransforms.at(j).toMatrix();
+			for(size_t k = 0; k < 16; ++k)
+				maxError = std::max(maxError, std::abs(baked[k] - frame.at(j)[k]));
+		}
+	}
+
+	const size_t bakedUsage = tickCount * nodeTransforms.size() * sizeof(M4);
+	LOGD("Animation \"%s\": %zu bytes of keyframes, %zu bytes baked at %.0f tps, max matrix element error %f", animation.name.c_str(), anim.memoryUsage(), bakedUsage, anim.tps(), maxError);
+}
+#endif
+
 }
 
 GltfImporter::GltfImporter(const String& src, MaterialBundle::Initializer& materialInitializer)
@@ -525,27 +624,11 @@ Model GltfImporter::loadModel()
 		}
 
 		const float tps = 24.0f;
-		const float tickInterval = 1.0f / tps;
+		const Map<uint32_t, M4> inverseBindMatrices = loadInverseBindMatrices(_model);
 
-		Vector<NodeTransform> nodeTransforms(channelNodeIds.size());
 		for(Animation& animation : loadingAnimations)
 		{
-			const uint32_t tickCount = static_cast<uint32_t>(animation.end * tps);
-			Vector<AnimationFrame> frames(tickCount);
-			initNodeTransforms(_nodes, nodeTransforms, channelNodeIds);
-
-			for(uint32_t i = 0; i < tickCount; ++i)
-			{
-				AnimationFrame animationFrame(channelNodeIds.size());
-
-				const float time = i * tickInterval;
-				updateAnimation(animation, nodeTransforms, channelNodeIds, time);
-
-				for(uint32_t j = 0; j < nodeTransforms.size(); ++j)
-					animationFrame[j] = nodeTransforms.at(j).toMatrix();
-
-				frames[i] = std::move(animationFrame);
-			}
+			Vector<ark::Animation::NodeTracks> nodeTracks = makeNodeTracks(animation, _nodes, channelNodeIds, inverseBindMatrices);
 
 			Table<String, uint32_t> nodeIds;
 			for(const auto [nodeId, frameNodeId] : channelNodeIds)
@@ -554,7 +637,10 @@ Model GltfImporter::loadModel()
 				nodeIds.push_back(node->name(), frameNodeId);
 			}
 
-			auto anim = sp<ark::Animation>::make(animation.name, tickCount, std::move(nodeIds), std::move(frames));
+			auto anim = sp<ark::Animation>::make(animation.name, tps, animation.end, std::move(nodeIds), std::move(nodeTracks));
+#if ARK_FLAG_BUILD_TYPE == 1
+			reportAnimation(animation, *anim, _nodes, channelNodeIds);
+#endif
 			animations.push_back(std::move(animation.name), std::move(anim));
 		}
 	}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+
+namespace ark::plugin::headless {
+
+//  What the headless backend records in place of GPU work. Shared by all its delegates and put into RenderBackendInfo::traits(), so benchmarks can read it back.
+//  Only touched from the renderer thread, except for the frame times which ApplicationHeadless records on the same thread between frames.
+struct HeadlessStatistics {
+    uint64_t _frame_count = 0;
+    uint64_t _frame_time_ns = 0;
+    uint64_t _frame_time_max_ns = 0;
+
+    uint64_t _draw_calls = 0;
+//  Elements for plain draws, instances for instanced ones and commands for indirect ones.
+    uint64_t _draw_count = 0;
+    uint64_t _compute_dispatches = 0;
+
+    uint64_t _pipeline_uploads = 0;
+    uint64_t _buffer_uploads = 0;
+    uint64_t _buffer_upload_bytes = 0;
+    uint64_t _texture_uploads = 0;
+    uint64_t _texture_upload_bytes = 0;
+
+    uint64_t _resources_created = 0;
+};
+
+}
@@ -0,0 +1,101 @@
+#include "headless/impl/application/application_headless.h"
+
+#include <chrono>
+#include <cinttypes>
+
+#include "core/collection/traits.h"
+#include "core/inf/variable.h"
+#include "core/types/box.h"
+#include "core/util/documents.h"
+#include "core/util/log.h"
+
+#include "graphics/components/size.h"
+
+#include "renderer/base/render_backend.h"
+#include "renderer/base/render_backend_info.h"
+
+#include "app/base/application_context.h"
+#include "app/base/application_manifest.h"
+#include "app/inf/application_controller.h"
+
+#include "headless/base/headless_statistics.h"
+
+namespace ark::plugin::headless {
+
+namespace {
+
+class ApplicationControllerHeadless final : public ApplicationController {
+public:
+    Box createCursor(const sp<Bitmap>& /*bitmap*/, int32_t /*hotX*/, int32_t /*hotY*/) override {
+        return nullptr;
+    }
+
+    Box createSystemCursor(SystemCursorName /*name*/) override {
+        return nullptr;
+    }
+
+    void showCursor(const Box& /*cursor*/) override {
+    }
+
+    void hideCursor() override {
+    }
+
+    void setMouseCapture(bool /*enabled*/) override {
+    }
+};
+
+}
+
+ApplicationHeadless::ApplicationHeadless(sp<ApplicationContext> applicationContext, const ApplicationManifest& manifest, sp<ApplicationDelegate> applicationDelegate)
+    : Application(std::move(applicationContext), manifest, std::move(applicationDelegate)), _controller(sp<ApplicationController>::make<ApplicationControllerHeadless>()),
+      _frame_limit(Documents::getAttributeValue<uint32_t>(manifest.content(), "headless/frames", 0))
+{
+}
+
+int ApplicationHeadless::run()
+{
+    Boolean& quitting = _application_context->quitting();
+    const sp<HeadlessStatistics> statistics = _application_context->renderEngine()->info()->traits().get<HeadlessStatistics>();
+
+    onCreate();
+    onSurfaceCreated();
+    onSurfaceChanged(static_cast<uint32_t>(_surface_size->widthAsFloat()), static_cast<uint32_t>(_surface_size->heightAsFloat()));
+    _application_context->updateState();
+
+    for(uint32_t i = 0; (_frame_limit == 0 || i < _frame_limit) && !quitting.val(); ++i)
+    {
+        const std::chrono::steady_clock::time_point frameBegin = std::chrono::steady_clock::now();
+        onSurfaceUpdate();
+        if(statistics)
+        {
+            const uint64_t frameTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - frameBegin).count();
+            ++ statistics->_frame_count;
+            statistics->_frame_time_ns += frameTime;
+            statistics->_frame_time_max_ns = std::max(statistics->_frame_time_max_ns, frameTime);
+        }
+    }
+
+    onDestroy();
+
+    if(statistics && statistics->_frame_count)
+        Log::d("ApplicationHeadless", Strings::sprintf("frames: %" PRIu64 ", average: %.3fms, max: %.3fms, draw calls: %" PRIu64 ", draw count: %" PRIu64 ", compute dispatches: %" PRIu64
+                                                         ", buffer uploads: %" PRIu64 " (%" PRIu64 " bytes), texture uploads: %" PRIu64 " (%" PRIu64 " bytes)",
+                                                         statistics->_frame_count, statistics->_frame_time_ns / 1000000.0 / statistics->_frame_count, statistics->_frame_time_max_ns / 1000000.0,
+                                                         statistics->_draw_calls, statistics->_draw_count, statistics->_compute_dispatches, statistics->_buffer_uploads, statistics->_buffer_upload_bytes,
+                                                         statistics->_texture_uploads, statistics->_texture_upload_bytes).c_str());
+    return 0;
+}
+
+const sp<ApplicationController>& ApplicationHeadless::controller()
+{
+    return _controller;
+}
+
+sp<Application> ApplicationHeadless::BUILDER::build(const Scope& /*args*/)
+{
+    const Ark& ark = Ark::instance();
+    const ApplicationManifest& manifest = ark.manifest();
+    return sp<Application>::make<ApplicationHeadless>(ark.applicationContext(), manifest);
+}
+
+}
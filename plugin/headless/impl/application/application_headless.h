@@ -0,0 +1,33 @@
+#pragma once
+
+#include "core/forwarding.h"
+#include "core/inf/builder.h"
+
+#include "app/base/application.h"
+
+namespace ark::plugin::headless {
+
+//  Drives the Surface without a window or an event loop, as fast as it can, e.g. for CPU frame-time benchmarks and server-side game logic.
+//  Runs until the application quits or for the number of frames given by the manifest's <headless frames="..."/>, then logs the recorded HeadlessStatistics.
+//  Selected by <application class="headless"/> in the manifest, it never replaces the platform's default Application.
+class ApplicationHeadless final : public Application {
+public:
+    ApplicationHeadless(sp<ApplicationContext> applicationContext, const ApplicationManifest& manifest, sp<ApplicationDelegate> applicationDelegate = nullptr);
+
+    int run() override;
+    const sp<ApplicationController>& controller() override;
+
+//  [[plugin::builder("headless")]]
+    class BUILDER final : public Builder<Application> {
+    public:
+        BUILDER() = default;
+
+        sp<Application> build(const Scope& args) override;
+    };
+
+private:
+    sp<ApplicationController> _controller;
+    uint32_t _frame_limit;
+};
+
+}
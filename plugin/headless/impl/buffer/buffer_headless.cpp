@@ -0,0 +1,77 @@
+#include "headless/impl/buffer/buffer_headless.h"
+
+#include "core/inf/uploader.h"
+#include "core/inf/writable.h"
+
+#include "renderer/inf/recyclable.h"
+
+namespace ark::plugin::headless {
+
+namespace {
+
+class WritableHeadless final : public Writable {
+public:
+    WritableHeadless(Vector<uint8_t>& data)
+        : _data(data), _written(0) {
+    }
+
+    uint32_t write(const void* buffer, const uint32_t size, const uint32_t offset) override {
+        if(_data.size() < offset + size)
+            _data.resize(offset + size);
+        memcpy(_data.data() + offset, buffer, size);
+        _written += size;
+        return size;
+    }
+
+    size_t written() const {
+        return _written;
+    }
+
+private:
+    Vector<uint8_t>& _data;
+    size_t _written;
+};
+
+}
+
+BufferHeadless::BufferHeadless(sp<HeadlessStatistics> statistics)
+    : _statistics(std::move(statistics)), _id(0)
+{
+}
+
+uint64_t BufferHeadless::id()
+{
+    return _id;
+}
+
+void BufferHeadless::upload(GraphicsContext& /*graphicsContext*/)
+{
+}
+
+op<Recyclable> BufferHeadless::toRecyclable()
+{
+    _id = 0;
+    _data.clear();
+    return nullptr;
+}
+
+void BufferHeadless::uploadBuffer(GraphicsContext& /*graphicsContext*/, Uploader& uploader)
+{
+    if(!_id)
+        _id = ++ _statistics->_resources_created;
+
+    _data.resize(std::max(_data.size(), uploader.size()));
+    WritableHeadless writable(_data);
+    uploader.upload(writable);
+
+    ++ _statistics->_buffer_uploads;
+    _statistics->_buffer_upload_bytes += writable.written();
+}
+
+void BufferHeadless::downloadBuffer(GraphicsContext& /*graphicsContext*/, const size_t offset, const size_t size, void* ptr)
+{
+    DCHECK(offset + size <= _data.size(), "Downloading out of bounds, offset: %d, size: %d, buffer size: %d", offset, size, _data.size());
+    memcpy(ptr, _data.data() + offset, size);
+}
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "core/types/shared_ptr.h"
+
+#include "renderer/base/buffer.h"
+
+#include "headless/base/headless_statistics.h"
+
+namespace ark::plugin::headless {
+
+class BufferHeadless final : public Buffer::Delegate {
+public:
+    BufferHeadless(sp<HeadlessStatistics> statistics);
+
+    uint64_t id() override;
+    void upload(GraphicsContext& graphicsContext) override;
+    op<Recyclable> toRecyclable() override;
+    void uploadBuffer(GraphicsContext& graphicsContext, Uploader& uploader) override;
+    void downloadBuffer(GraphicsContext& graphicsContext, size_t offset, size_t size, void* ptr) override;
+
+private:
+    sp<HeadlessStatistics> _statistics;
+    uint64_t _id;
+    Vector<uint8_t> _data;
+};
+
+}
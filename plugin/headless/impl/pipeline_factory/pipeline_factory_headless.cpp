@@ -0,0 +1,82 @@
+#include "headless/impl/pipeline_factory/pipeline_factory_headless.h"
+
+#include "renderer/base/compute_context.h"
+#include "renderer/base/drawing_context.h"
+#include "renderer/base/pipeline_bindings.h"
+#include "renderer/inf/pipeline.h"
+#include "renderer/inf/recyclable.h"
+
+namespace ark::plugin::headless {
+
+namespace {
+
+class PipelineHeadless final : public Pipeline {
+public:
+    PipelineHeadless(sp<HeadlessStatistics> statistics, const enums::DrawProcedure drawProcedure)
+        : _statistics(std::move(statistics)), _draw_procedure(drawProcedure), _id(0) {
+    }
+
+    uint64_t id() override {
+        return _id;
+    }
+
+    void upload(GraphicsContext& /*graphicsContext*/) override {
+        if(!_id) {
+            _id = ++ _statistics->_resources_created;
+            ++ _statistics->_pipeline_uploads;
+        }
+    }
+
+    op<Recyclable> toRecyclable() override {
+        _id = 0;
+        return nullptr;
+    }
+
+//  Instance and indirect buffers are uploaded by the pipelines of the other backends too, so they're uploaded here as well to keep their CPU cost in the measurement.
+    void draw(GraphicsContext& graphicsContext, const DrawingContext& drawingContext) override {
+        ++ _statistics->_draw_calls;
+        switch(_draw_procedure) {
+            case enums::DRAW_PROCEDURE_DRAW_INSTANCED: {
+                const DrawingParams::DrawElementsInstanced& param = drawingContext._parameters.drawElementsInstanced();
+                for(const auto& [i, j] : param._instance_buffer_snapshots)
+                    j.upload(graphicsContext);
+                _statistics->_draw_count += drawingContext._draw_count;
+                break;
+            }
+            case enums::DRAW_PROCEDURE_DRAW_INSTANCED_INDIRECT: {
+                const DrawingParams::DrawMultiElementsIndirect& param = drawingContext._parameters.drawMultiElementsIndirect();
+                for(const auto& [i, j] : param._instance_buffer_snapshots)
+                    j.upload(graphicsContext);
+                param._indirect_cmds.upload(graphicsContext);
+                _statistics->_draw_count += param._indirect_cmd_count;
+                break;
+            }
+            default:
+                _statistics->_draw_count += drawingContext._draw_count;
+                break;
+        }
+    }
+
+    void compute(GraphicsContext& /*graphicsContext*/, const ComputeContext& /*computeContext*/) override {
+        ++ _statistics->_compute_dispatches;
+    }
+
+private:
+    sp<HeadlessStatistics> _statistics;
+    enums::DrawProcedure _draw_procedure;
+    uint64_t _id;
+};
+
+}
+
+PipelineFactoryHeadless::PipelineFactoryHeadless(sp<HeadlessStatistics> statistics)
+    : _statistics(std::move(statistics))
+{
+}
+
+sp<Pipeline> PipelineFactoryHeadless::buildPipeline(GraphicsContext& /*graphicsContext*/, const PipelineBindings& pipelineBindings, std::map<enums::ShaderStageBit, String> /*stages*/)
+{
+    return sp<Pipeline>::make<PipelineHeadless>(_statistics, pipelineBindings.drawProcedure());
+}
+
+}
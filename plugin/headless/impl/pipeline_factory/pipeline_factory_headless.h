@@ -0,0 +1,21 @@
+#pragma once
+
+#include "core/types/shared_ptr.h"
+
+#include "renderer/inf/pipeline_factory.h"
+
+#include "headless/base/headless_statistics.h"
+
+namespace ark::plugin::headless {
+
+class PipelineFactoryHeadless final : public PipelineFactory {
+public:
+    PipelineFactoryHeadless(sp<HeadlessStatistics> statistics);
+
+    sp<Pipeline> buildPipeline(GraphicsContext& graphicsContext, const PipelineBindings& pipelineBindings, std::map<enums::ShaderStageBit, String> stages) override;
+
+private:
+    sp<HeadlessStatistics> _statistics;
+};
+
+}
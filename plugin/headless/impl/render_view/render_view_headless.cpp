@@ -0,0 +1,41 @@
+#include "headless/impl/render_view/render_view_headless.h"
+
+#include "graphics/base/bitmap.h"
+#include "graphics/inf/render_command.h"
+
+#include "renderer/base/graphics_context.h"
+#include "renderer/base/render_backend.h"
+#include "renderer/base/render_backend_info.h"
+#include "renderer/base/render_controller.h"
+
+namespace ark::plugin::headless {
+
+RenderViewHeadless::RenderViewHeadless(sp<RenderController> renderController)
+    : _render_controller(std::move(renderController))
+{
+}
+
+void RenderViewHeadless::onSurfaceCreated()
+{
+}
+
+void RenderViewHeadless::onSurfaceChanged(uint32_t /*width*/, uint32_t /*height*/)
+{
+    _render_controller->onSurfaceReady(GraphicsContext::mocked());
+}
+
+void RenderViewHeadless::onRenderFrame(const V4& /*backgroundColor*/, RenderCommand& renderCommand)
+{
+    GraphicsContext graphicsContext(_render_controller);
+    graphicsContext.onDrawFrame();
+    renderCommand.draw(graphicsContext);
+}
+
+sp<Bitmap> RenderViewHeadless::doScreenshot()
+{
+    constexpr uint8_t channels = 3;
+    const auto [width, height] = _render_controller->renderBackend()->info()->displayResolution();
+    return sp<Bitmap>::make(width, height, width * channels, channels, true);
+}
+
+}
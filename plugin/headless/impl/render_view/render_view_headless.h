@@ -0,0 +1,26 @@
+#pragma once
+
+#include "core/types/shared_ptr.h"
+
+#include "graphics/forwarding.h"
+#include "graphics/inf/render_view.h"
+
+#include "renderer/forwarding.h"
+
+namespace ark::plugin::headless {
+
+class RenderViewHeadless final : public RenderView {
+public:
+    RenderViewHeadless(sp<RenderController> renderController);
+
+    void onSurfaceCreated() override;
+    void onSurfaceChanged(uint32_t width, uint32_t height) override;
+    void onRenderFrame(const V4& backgroundColor, RenderCommand& renderCommand) override;
+
+    sp<Bitmap> doScreenshot() override;
+
+private:
+    sp<RenderController> _render_controller;
+};
+
+}
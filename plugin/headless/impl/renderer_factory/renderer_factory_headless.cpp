@@ -0,0 +1,78 @@
+#include "headless/impl/renderer_factory/renderer_factory_headless.h"
+
+#include "core/collection/traits.h"
+
+#include "graphics/base/viewport.h"
+
+#include "renderer/base/render_backend_info.h"
+#include "renderer/base/render_target.h"
+#include "renderer/inf/snippet.h"
+#include "renderer/inf/snippet_factory.h"
+
+#include "headless/impl/buffer/buffer_headless.h"
+#include "headless/impl/pipeline_factory/pipeline_factory_headless.h"
+#include "headless/impl/render_view/render_view_headless.h"
+#include "headless/impl/texture/texture_headless.h"
+
+namespace ark::plugin::headless {
+
+namespace {
+
+class SnippetFactoryHeadless final : public SnippetFactory {
+public:
+    sp<Snippet> createCoreSnippet() override {
+        return sp<Snippet>::make();
+    }
+};
+
+}
+
+RendererFactoryHeadless::RendererFactoryHeadless()
+    : RendererFactory({{}, sizeof(float)}), _statistics(sp<HeadlessStatistics>::make())
+{
+}
+
+void RendererFactoryHeadless::onSurfaceCreated(RenderBackend& /*renderEngine*/)
+{
+}
+
+sp<RenderBackendInfo> RendererFactoryHeadless::createRenderBackendInfo(const ApplicationManifest::Renderer& renderer)
+{
+    sp<RenderBackendInfo> renderContext = sp<RenderBackendInfo>::make(renderer, Viewport(-1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f), enums::COORDINATE_SYSTEM_RHS, enums::COORDINATE_SYSTEM_LHS, enums::NDC_DEPTH_RANGE_NEGATIVE_ONE_TO_ONE);
+    renderContext->setSnippetFactory(sp<SnippetFactory>::make<SnippetFactoryHeadless>());
+    renderContext->traits().put<HeadlessStatistics>(_statistics);
+    return renderContext;
+}
+
+sp<Buffer::Delegate> RendererFactoryHeadless::createBuffer(Buffer::Usage /*usage*/)
+{
+    return sp<Buffer::Delegate>::make<BufferHeadless>(_statistics);
+}
+
+sp<RenderTarget> RendererFactoryHeadless::createRenderTarget(sp<Renderer> renderer, RenderTarget::Configure /*configure*/)
+{
+    sp<Renderer> fboRenderer = renderer;
+    return sp<RenderTarget>::make(std::move(renderer), nullptr, std::move(fboRenderer));
+}
+
+sp<PipelineFactory> RendererFactoryHeadless::createPipelineFactory()
+{
+    return sp<PipelineFactory>::make<PipelineFactoryHeadless>(_statistics);
+}
+
+sp<RenderView> RendererFactoryHeadless::createRenderView(const sp<RenderBackendInfo>& /*renderContext*/, const sp<RenderController>& renderController)
+{
+    return sp<RenderView>::make<RenderViewHeadless>(renderController);
+}
+
+sp<Texture::Delegate> RendererFactoryHeadless::createTexture(sp<Size> /*size*/, sp<Texture::Parameters> parameters)
+{
+    return sp<Texture::Delegate>::make<TextureHeadless>(_statistics, parameters->_type);
+}
+
+sp<RendererFactory> RendererFactoryHeadless::BUILDER::build(const Scope& /*args*/)
+{
+    return sp<RendererFactory>::make<RendererFactoryHeadless>();
+}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "core/inf/builder.h"
+#include "core/types/shared_ptr.h"
+
+#include "renderer/forwarding.h"
+#include "renderer/inf/renderer_factory.h"
+
+#include "headless/base/headless_statistics.h"
+
+namespace ark::plugin::headless {
+
+//  A RendererFactory without GPU work: resources keep host memory or nothing at all, draws and uploads are only counted into HeadlessStatistics.
+//  It supports no rendering backend, so it's only picked by naming it in the manifest, <renderer class="headless"/>.
+class RendererFactoryHeadless final : public RendererFactory {
+public:
+    RendererFactoryHeadless();
+
+    void onSurfaceCreated(RenderBackend& renderEngine) override;
+
+    sp<RenderBackendInfo> createRenderBackendInfo(const ApplicationManifest::Renderer& renderer) override;
+    sp<Buffer::Delegate> createBuffer(Buffer::Usage usage) override;
+    sp<RenderTarget> createRenderTarget(sp<Renderer> renderer, RenderTarget::Configure configure) override;
+    sp<PipelineFactory> createPipelineFactory() override;
+    sp<RenderView> createRenderView(const sp<RenderBackendInfo>& renderContext, const sp<RenderController>& renderController) override;
+    sp<Texture::Delegate> createTexture(sp<Size> size, sp<Texture::Parameters> parameters) override;
+
+//  [[plugin::builder::by-value("headless")]]
+    class BUILDER final : public Builder<RendererFactory> {
+    public:
+        BUILDER() = default;
+
+        sp<RendererFactory> build(const Scope& args) override;
+    };
+
+private:
+    sp<HeadlessStatistics> _statistics;
+};
+
+}
@@ -0,0 +1,54 @@
+#include "headless/impl/texture/texture_headless.h"
+
+#include "core/inf/array.h"
+
+#include "renderer/inf/recyclable.h"
+
+namespace ark::plugin::headless {
+
+TextureHeadless::TextureHeadless(sp<HeadlessStatistics> statistics, const Texture::Type type)
+    : Delegate(type), _statistics(std::move(statistics)), _id(0)
+{
+}
+
+uint64_t TextureHeadless::id()
+{
+    return _id;
+}
+
+void TextureHeadless::upload(GraphicsContext& graphicsContext, const sp<Texture::Uploader>& uploader)
+{
+    if(!_id)
+    {
+        _id = ++ _statistics->_resources_created;
+        if(uploader)
+            uploader->initialize(graphicsContext, *this);
+    }
+    else if(uploader)
+        uploader->update(graphicsContext, *this);
+}
+
+op<Recyclable> TextureHeadless::toRecyclable()
+{
+    _id = 0;
+    return nullptr;
+}
+
+void TextureHeadless::clear(GraphicsContext& /*graphicsContext*/)
+{
+}
+
+bool TextureHeadless::download(GraphicsContext& /*graphicsContext*/, Bitmap& /*bitmap*/)
+{
+    return false;
+}
+
+void TextureHeadless::uploadBitmap(GraphicsContext& /*graphicsContext*/, const Bitmap& /*bitmap*/, const Vector<sp<ByteArray>>& imagedata)
+{
+    ++ _statistics->_texture_uploads;
+    for(const sp<ByteArray>& i : imagedata)
+        if(i)
+            _statistics->_texture_upload_bytes += i->size();
+}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "core/types/shared_ptr.h"
+
+#include "renderer/base/texture.h"
+
+#include "headless/base/headless_statistics.h"
+
+namespace ark::plugin::headless {
+
+class TextureHeadless final : public Texture::Delegate {
+public:
+    TextureHeadless(sp<HeadlessStatistics> statistics, Texture::Type type);
+
+    uint64_t id() override;
+    void upload(GraphicsContext& graphicsContext, const sp<Texture::Uploader>& uploader) override;
+    op<Recyclable> toRecyclable() override;
+
+    void clear(GraphicsContext& graphicsContext) override;
+    bool download(GraphicsContext& graphicsContext, Bitmap& bitmap) override;
+    void uploadBitmap(GraphicsContext& graphicsContext, const Bitmap& bitmap, const Vector<sp<ByteArray>>& imagedata) override;
+
+private:
+    sp<HeadlessStatistics> _statistics;
+    uint64_t _id;
+};
+
+}
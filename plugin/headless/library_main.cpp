@@ -0,0 +1,16 @@
+#include "core/base/plugin.h"
+
+#include "core/ark.h"
+#include "core/base/api.h"
+
+#include "generated/headless_plugin.h"
+
+using namespace ark;
+using namespace ark::plugin::headless;
+
+extern "C" ARK_API Plugin* __ark_headless_initialize__(Ark&);
+
+Plugin* __ark_headless_initialize__(Ark& /*ark*/)
+{
+    return new HeadlessPlugin();
+}
@@ -1,5 +1,8 @@
 #include "python/extension/py_cast.h"
 
+#include <bit>
+#include <cstring>
+
 #include "core/base/json.h"
 #include "core/base/observer.h"
 #include "core/base/named_hash.h"
@@ -128,6 +131,30 @@ String unicodeToUTF8String(PyObject* object, const char* encoding, const char* e
     return PyUnicode_AsUTF8(object);
 }
 
+struct ExportedPyBuffer {
+    Box _array;
+    Py_ssize_t _shape;
+    Py_ssize_t _stride;
+};
+
+//  Buffer format characters grouped by element kind, e.g. int32 arrays are "i" from array.array but "l" from numpy on Windows.
+char toPyBufferKind(const char* format)
+{
+    if(!format)
+        return 'u';
+    if(*format == '@' || *format == '=' || *format == (std::endian::native == std::endian::little ? '<' : '>'))
+        ++format;
+    if(format[0] == 0 || format[1] != 0)
+        return 0;
+    if(std::strchr("efd", format[0]))
+        return 'f';
+    if(std::strchr("bhilqn", format[0]))
+        return 'i';
+    if(std::strchr("BHILQN", format[0]))
+        return 'u';
+    return 0;
+}
+
 }
 
 Optional<sp<Runnable>> PyCast::toRunnable(PyObject* object)
@@ -346,6 +373,55 @@ bool PyCast::isNoneOrNull(PyObject* pyObject)
     return !pyObject || pyObject == Py_None;
 }
 
+void PyCast::releasePyBuffer(PyObject* /*exporter*/, Py_buffer* view)
+{
+    delete static_cast<ExportedPyBuffer*>(view->internal);
+}
+
+int PyCast::toPyBuffer(Box array, void* buf, const size_t length, const size_t itemSize, const char* format, PyObject* exporter, Py_buffer* view, const int flags)
+{
+    if(!view)
+    {
+        PyErr_SetString(PyExc_BufferError, "NULL view in getbuffer");
+        return -1;
+    }
+
+    ExportedPyBuffer* exported = new ExportedPyBuffer{std::move(array), static_cast<Py_ssize_t>(length), static_cast<Py_ssize_t>(itemSize)};
+    Py_INCREF(exporter);
+    view->obj = exporter;
+    view->buf = buf;
+    view->len = static_cast<Py_ssize_t>(length * itemSize);
+    view->readonly = 0;
+    view->itemsize = static_cast<Py_ssize_t>(itemSize);
+    view->format = flags & PyBUF_FORMAT ? const_cast<char*>(format) : nullptr;
+    view->ndim = 1;
+    view->shape = flags & PyBUF_ND ? &exported->_shape : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? &exported->_stride : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = exported;
+    return 0;
+}
+
+PyObject* PyCast::toPyMemoryView(PyObject* object, const size_t itemSize, const char* format)
+{
+    if(!PyObject_CheckBuffer(object))
+        return nullptr;
+
+    PyObject* memoryView = PyMemoryView_FromObject(object);
+    if(!memoryView)
+    {
+        PyErr_Clear();
+        return nullptr;
+    }
+
+    if(const Py_buffer* view = PyMemoryView_GET_BUFFER(memoryView); PyBuffer_IsContiguous(view, 'C')
+        && (!format || (static_cast<size_t>(view->itemsize) == itemSize && toPyBufferKind(view->format) == toPyBufferKind(format))))
+        return memoryView;
+
+    Py_DECREF(memoryView);
+    return nullptr;
+}
+
 template<> ARK_PLUGIN_PYTHON_API Optional<String> PyCast::toCppObject_impl<String>(PyObject* object)
 {
     return toStringExact(object);
@@ -21,6 +21,7 @@
 
 #include "python/api.h"
 #include "python/extension/py_instance.h"
+#include "python/extension/py_instance_ref.h"
 #include "python/extension/python_extension.h"
 #include "python/extension/py_bridge.h"
 
@@ -94,6 +95,14 @@ public:
 
     static bool isNoneOrNull(PyObject* pyObject);
 
+//  PEP 3118 export of the array's storage, the view keeps "array" alive until it gets released.
+    template<typename T> static int toPyBuffer(sp<Array<T>> array, PyObject* exporter, Py_buffer* view, const int flags) {
+        T* buf = array->buf();
+        const size_t length = array->length();
+        return toPyBuffer(Box(std::move(array)), buf, length, sizeof(T), toPyBufferFormat<T>(), exporter, view, flags);
+    }
+    static void releasePyBuffer(PyObject* exporter, Py_buffer* view);
+
     template<typename F, F f> struct func_wrapper_impl;
     template<typename R, typename... Args, R(*f)(Args...)> struct func_wrapper_impl<R(*)(Args...), f> {
         static R wrapped(Args... args) {
@@ -114,10 +123,43 @@ public:
     template<typename F, F f> constexpr static auto RuntimeFuncWrapper = func_wrapper_impl<F, f>::wrapped;
 
 private:
+    template<typename T> class PyBufferArray;
+
     template<typename T> static Optional<sp<T>> toSharedPtrImpl(PyObject* object) {
         return toSharedPtrDefault<T>(object);
     }
 
+    template<typename T> static constexpr const char* toPyBufferFormat() {
+        if constexpr(std::is_same_v<T, float>)
+            return "f";
+        else if constexpr(std::is_same_v<T, double>)
+            return "d";
+        else if constexpr(std::is_same_v<T, int8_t>)
+            return "b";
+        else if constexpr(std::is_same_v<T, uint8_t>)
+            return "B";
+        else if constexpr(std::is_same_v<T, int16_t>)
+            return "h";
+        else if constexpr(std::is_same_v<T, uint16_t>)
+            return "H";
+        else if constexpr(std::is_same_v<T, int32_t>)
+            return "i";
+        else if constexpr(std::is_same_v<T, uint32_t>)
+            return "I";
+        else
+            static_assert(sizeof(T) == 0, "Unsupported buffer element type");
+    }
+
+    static int toPyBuffer(Box array, void* buf, size_t length, size_t itemSize, const char* format, PyObject* exporter, Py_buffer* view, int flags);
+//  Returns a new memoryview reference if "object" exports a C-contiguous buffer of "itemSize" sized "format" elements, a null "format" accepts any buffer as bytes.
+    static PyObject* toPyMemoryView(PyObject* object, size_t itemSize, const char* format);
+
+    template<typename T> static Optional<sp<Array<T>>> toArrayFromPyBuffer(PyObject* object) {
+        if(PyObject* memoryView = toPyMemoryView(object, sizeof(T), std::is_same_v<T, uint8_t> ? nullptr : toPyBufferFormat<T>()))
+            return {sp<Array<T>>::template make<PyBufferArray<T>>(memoryView)};
+        return {};
+    }
+
     template<typename T> static sp<T> toSharedPtrOrNull(PyObject* object) {
         if(PyBridge::isPyNone(object))
             return nullptr;
@@ -440,20 +482,47 @@ template<> inline Optional<sp<Mat4>> PyCast::toSharedPtrImpl<Mat4>(PyObject* obj
     return toMat4(object);
 }
 
+//  Zero-copy view over a foreign buffer, the memoryview pins the exporter and is handed back to the interpreter on destruction.
+template<typename T> class PyCast::PyBufferArray final : public Array<T> {
+public:
+    PyBufferArray(PyObject* memoryView)
+        : _memory_view(memoryView, true), _buf(static_cast<T*>(PyMemoryView_GET_BUFFER(memoryView)->buf)), _length(PyMemoryView_GET_BUFFER(memoryView)->len / sizeof(T)) {
+    }
+
+    size_t length() override {
+        return _length;
+    }
+
+    T* buf() override {
+        return _buf;
+    }
+
+private:
+    PyInstanceRef _memory_view;
+    T* _buf;
+    size_t _length;
+};
+
 template<> inline Optional<sp<ByteArray>> PyCast::toSharedPtrImpl<ByteArray>(PyObject* object) {
+    if(Optional<sp<ByteArray>> opt = toSharedPtrDefault<ByteArray>(object))
+        return opt;
     if(PyBytes_Check(object)) {
         Py_ssize_t len = PyBytes_Size(object);
         return sp<ByteArray>::make<ByteArray::View>(reinterpret_cast<uint8_t*>(PyBytes_AsString(object)), len);
     }
-    if(PyObject_CheckBuffer(object)) {
-        Py_buffer buf;
-        PyObject_GetBuffer(object, &buf, PyBUF_C_CONTIGUOUS);
-        sp<ByteArray> array = sp<ByteArray>::make<ByteArray::Allocated>(buf.len);
-        memcpy(array->buf(), buf.buf, buf.len);
-        PyBuffer_Release(&buf);
-        return array;
-    }
-    return toSharedPtrDefault<ByteArray>(object);
+    return toArrayFromPyBuffer<uint8_t>(object);
+}
+
+template<> inline Optional<sp<IntArray>> PyCast::toSharedPtrImpl<IntArray>(PyObject* object) {
+    if(Optional<sp<IntArray>> opt = toSharedPtrDefault<IntArray>(object))
+        return opt;
+    return toArrayFromPyBuffer<int32_t>(object);
+}
+
+template<> inline Optional<sp<FloatArray>> PyCast::toSharedPtrImpl<FloatArray>(PyObject* object) {
+    if(Optional<sp<FloatArray>> opt = toSharedPtrDefault<FloatArray>(object))
+        return opt;
+    return toArrayFromPyBuffer<float>(object);
 }
 
 }
@@ -1,12 +1,15 @@
 #include "python/extension/python_extension.h"
 
+#include "core/ark.h"
 #include "core/base/json.h"
 #include "core/base/observer.h"
 #include "core/base/scope.h"
 #include "core/types/box.h"
 #include "core/types/global.h"
 
+#include "app/base/application_context.h"
 #include "app/base/searching_node.h"
+#include "app/inf/application_profiler.h"
 #include "core/collection/args.h"
 
 #include "python/extension/callable.h"
@@ -63,6 +66,7 @@ PythonExtension& PythonExtension::instance()
 }
 
 PythonExtension::PythonExtension()
+    : _dispatch_scheduled(false)
 {
 }
 
@@ -184,4 +188,63 @@ void PythonExtension::recyclePyObject(PyObject* pyObject)
     _recycled_py_objects.push_back(pyObject);
 }
 
+void PythonExtension::dispatch(PyInstance callable)
+{
+    if(const sp<ApplicationContext>& applicationContext = Ark::instance().applicationContext(); applicationContext && __thread_check__(THREAD_NAME_ID_CORE))
+    {
+        const std::lock_guard<std::mutex> guard(_dispatch_mutex);
+        _dispatch_queue.push_back(std::move(callable));
+        if(!_dispatch_scheduled)
+        {
+            _dispatch_scheduled = true;
+            applicationContext->runAtCoreTaskEnd([this] {
+                flushDispatchQueue();
+            });
+        }
+        return;
+    }
+
+    const auto gil = ensureGIL();
+    const PyInstance args(PyInstance::steal(PyTuple_New(0)));
+    callDispatched(callable, args);
+}
+
+void PythonExtension::flushDispatchQueue()
+{
+    DTHREAD_CHECK(THREAD_NAME_ID_CORE);
+    DPROFILER_TRACE("ScriptDispatch", ApplicationProfiler::CATEGORY_SCRIPT);
+
+    const auto gil = ensureGIL();
+    const PyInstance args(PyInstance::steal(PyTuple_New(0)));
+    Vector<PyInstance> dispatching;
+    while(true)
+    {
+        {
+            const std::lock_guard<std::mutex> guard(_dispatch_mutex);
+            if(_dispatch_queue.empty())
+            {
+                _dispatch_scheduled = false;
+                break;
+            }
+            dispatching.swap(_dispatch_queue);
+        }
+        DPROFILER_LOG("Callbacks", dispatching.size());
+        for(const PyInstance& i : dispatching)
+            callDispatched(i, args);
+        dispatching.clear();
+    }
+}
+
+void PythonExtension::callDispatched(const PyInstance& callable, const PyInstance& args)
+{
+    CHECK_WARN(callable, "This PyObject has been recycled by Python garbage collector");
+    if(!callable.pyObject())
+        return;
+
+    if(PyObject* ret = callable.call(args.pyObject()))
+        Py_DECREF(ret);
+    else
+        logErr();
+}
+
 }
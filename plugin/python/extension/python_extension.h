@@ -2,6 +2,8 @@
 
 #include <Python.h>
 
+#include <mutex>
+
 #include "core/forwarding.h"
 #include "core/types/shared_ptr.h"
 
@@ -15,6 +17,7 @@
 #include "python/impl/interpreter/python_interpreter.h"
 #include "python/extension/py_ark_type.h"
 #include "python/extension/py_bridge.h"
+#include "python/extension/py_instance.h"
 
 namespace ark::plugin::python {
 
@@ -99,6 +102,15 @@ public:
     EnsureGIL ensureGIL();
     void recyclePyObject(PyObject* pyObject);
 
+//  Queues a Python callable from the core thread. The queue is flushed under a single GIL acquisition as soon as the current core task or
+//  message loop poll returns, so the callbacks it collects from event listeners, message loops and collisions don't each take and drop the GIL.
+//  The callbacks still run within the same task, never one task late. Off the core thread the callable is called right away and the queue is left alone.
+    void dispatch(PyInstance callable);
+
+private:
+    void flushDispatchQueue();
+    void callDispatched(const PyInstance& callable, const PyInstance& args);
+
 private:
     Map<TypeId, PyArkType*> _type_by_id;
     Map<void*, PyArkType*> _type_by_py_object;
@@ -106,6 +118,10 @@ private:
     PyThreadState* _thread_state;
     Vector<PyObject*> _recycled_py_objects;
 
+    std::mutex _dispatch_mutex;
+    Vector<PyInstance> _dispatch_queue;
+    bool _dispatch_scheduled;
+
     friend class PythonInterpreter;
 };
 
@@ -1,7 +1,5 @@
 #include "python/impl/adapter/runnable_python.h"
 
-#include "core/util/log.h"
-
 #include "python/api.h"
 #include "python/extension/python_extension.h"
 
@@ -15,17 +13,7 @@ RunnablePython::RunnablePython(PyInstance callable)
 void RunnablePython::run()
 {
     DCHECK_THREAD_FLAG();
-    const auto gil = PythonExtension::instance().ensureGIL();
-
-    CHECK_WARN(_callable, "This PyObject has been recycled by Python garbage collector");
-    if(_callable.pyObject())
-    {
-        const PyInstance args(PyInstance::steal(PyTuple_New(0)));
-        if(PyObject* ret = _callable.call(args.pyObject()))
-            Py_DECREF(ret);
-        else
-            PythonExtension::instance().logErr();
-    }
+    PythonExtension::instance().dispatch(_callable);
 }
 
 void RunnablePython::traverse(const Visitor& visitor)
@@ -985,6 +985,11 @@ class Animation:
     def get_global_transform(self, node: "Node", t: TYPE_INTEGER | TYPE_NUMERIC) -> Mat4: ...
 
 
+class AnimationEvaluator:
+    def __init__(self, chunk_size: int = 4): ...
+    def make_palette(self, animation: Animation, root_node: "Node", tick: TYPE_NUMERIC) -> Uploader: ...
+
+
 class MaterialMap:
     @property
     def color(self) -> Optional[Vec4]: ...
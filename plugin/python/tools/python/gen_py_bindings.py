@@ -38,6 +38,7 @@ AUTOBIND_METHOD_PATTERN = re.compile(r'\[\[script::bindings::(auto|classmethod|i
 AUTOBIND_CONSTRUCTOR_PATTERN = re.compile(r'\[\[script::bindings::constructor(?:\(([\w_]+)\))?]]\s+%s' % METHOD_PATTERN)
 AUTOBIND_AS_MAPPING_PATTERN = re.compile(r'\[\[script::bindings::map\(([^)]+)\)]]\s+%s' % METHOD_PATTERN)
 AUTOBIND_AS_SEQUENCE_PATTERN = re.compile(r'\[\[script::bindings::seq\(([^)]+)\)]]\s+%s' % METHOD_PATTERN)
+AUTOBIND_AS_BUFFER_PATTERN = re.compile(r'\[\[script::bindings::buffer]]\s+%s' % METHOD_PATTERN)
 AUTOBIND_OPERATOR_PATTERN = re.compile(r'\[\[script::bindings::operator\(([^)]+)\)]]\s+%s%s' % (ANNOTATION_PATTERN, METHOD_PATTERN))
 AUTOBIND_CLASS_PATTERN = re.compile(r'\[\[script::bindings::(class|name)(?:\(([^)]+)\))?]]')
 AUTOBIND_EXTENDS_PATTERN = re.compile(r'\[\[script::bindings::extends\((\w+)\)]]')
@@ -263,6 +264,9 @@ def gen_class_body_source(genclass, includes, lines, buildables):
         operator_defs = gen_as_number_operator_defs(genclass)
         gen_constructor_definition_source(genclass.py_class_name, 'as_number', operator_defs, lines, tp_method_lines)
 
+        as_buffer_defs = genclass.gen_as_buffer_defs()
+        gen_constructor_definition_source(genclass.py_class_name, 'as_buffer', as_buffer_defs, lines, tp_method_lines)
+
         rich_compare_defs = genclass.gen_rich_compare_defs()
         gen_constructor_definition_source(genclass.py_class_name, 'richcompare', rich_compare_defs, lines, tp_method_lines, 'richcmpfunc')
 
@@ -507,6 +511,25 @@ class GenRichCompareMethod(GenMethod):
             lines.append(ga.gen_declare(self, 'obj0', 'args'))
 
 
+class GenBufferMethod(GenMethod):
+    def __init__(self, name, args, return_type):
+        GenMethod.__init__(self, name, args, return_type)
+        self.self_argument = self.arguments and self.arguments[0]
+        self.arguments = self.arguments[1:]
+
+    def gen_py_return(self):
+        return 'int'
+
+    def gen_py_arguments(self):
+        return 'Instance* self, Py_buffer* view, int flags'
+
+    def gen_definition(self, genclass):
+        return '\n    '.join([
+            f'sp<{genclass.binding_classname}> unpacked = self->as<{genclass.binding_classname}>();',
+            f'return PyCast::toPyBuffer({genclass.classname}::{self.name}({self.gen_self_statement(genclass)}), reinterpret_cast<PyObject*>(self), view, flags);'
+        ])
+
+
 class GenClass:
     def __init__(self, filename: str, class_name: str, has_debris: bool = False):
         self.py_src_name = f'py_ark_{acg.camel_case_to_snake_case(class_name)}_type'
@@ -579,6 +602,9 @@ class GenClass:
     def sequence_methods(self):
         return self.find_methods_by_type(GenSequenceMethod)
 
+    def buffer_methods(self):
+        return self.find_methods_by_type(GenBufferMethod)
+
     @property
     def is_interface(self) -> bool:
         return bool(self.find_methods_by_type(GenInterfaceMethod))
@@ -610,6 +636,18 @@ class GenClass:
             i.gen_py_getset_def(property_defs, self)
         return property_defs
 
+    def gen_as_buffer_defs(self):
+        buffer_methods = self.buffer_methods()
+        if buffer_methods:
+            assert len(buffer_methods) == 1, "Only one buffer method allowed"
+            return [
+                f'static PyBufferProcs {self.py_class_name}_tp_as_buffer = {{',
+                f'    (getbufferproc) {self.py_class_name}::{buffer_methods[0].name}_r,     /* getbufferproc bf_getbuffer;         */',
+                '    (releasebufferproc) PyCast::releasePyBuffer, /* releasebufferproc bf_releasebuffer; */',
+                '};'
+            ]
+        return []
+
     def gen_rich_compare_defs(self):
         rich_compare_defs = []
         rich_compare_methods = self.rich_compare_methods()
@@ -766,6 +804,7 @@ def main(params, paths):
                               HeaderPattern(AUTOBIND_OPERATOR_PATTERN, autooperator),
                               HeaderPattern(AUTOBIND_AS_MAPPING_PATTERN, autoasmapping),
                               HeaderPattern(AUTOBIND_AS_SEQUENCE_PATTERN, autoassequence),
+                              HeaderPattern(AUTOBIND_AS_BUFFER_PATTERN, AutoMethodCall(GenBufferMethod, 3)),
                               HeaderPattern(AUTOBIND_CLASS_PATTERN, autoclass),
                               HeaderPattern(AUTOBIND_EXTENDS_PATTERN, autoextends),
                               HeaderPattern(AUTOBIND_LOADER_PATTERN, AutoMethodCall(GenLoaderMethod, 2)),
@@ -1,8 +1,10 @@
 #include "vulkan/base/vk_pipeline.h"
 
 #include "vk_instance.h"
+#include "core/ark.h"
 #include "core/base/observer.h"
 #include "core/impl/uploader/uploader_array.h"
+#include "core/util/parallel_util.h"
 
 #include "renderer/base/buffer.h"
 #include "renderer/base/compute_context.h"
@@ -13,6 +15,9 @@
 #include "renderer/base/recycler.h"
 #include "renderer/base/pipeline_bindings.h"
 #include "renderer/inf/recyclable.h"
+#include "renderer/util/render_util.h"
+
+#include "app/base/application_context.h"
 
 #include "vulkan/base/vk_buffer.h"
 #include "vulkan/base/vk_command_buffers.h"
@@ -552,9 +557,18 @@ void VKPipeline::setupGraphicsPipeline(GraphicsContext& graphicsContext)
         dynamicStateEnables.push_back(VK_DYNAMIC_STATE_SCISSOR);
     const VkPipelineDynamicStateCreateInfo dynamicState = vks::initializers::pipelineDynamicStateCreateInfo(dynamicStateEnables.data(), static_cast<uint32_t>(dynamicStateEnables.size()), 0);
 
-    Vector<VkPipelineShaderStageCreateInfo> shaderStages;
+    Vector<std::pair<enums::ShaderStageBit, const String*>> stageSources;
     for(const auto& [k, v] : _stages)
-        shaderStages.push_back(VKUtil::createShader(device->vkLogicalDevice(), v, k));
+        stageSources.emplace_back(k, &v);
+    Vector<Vector<uint32_t>> spirvs(stageSources.size());
+    ParallelUtil::forEachChunk(*Ark::instance().applicationContext()->threadPoolExecutor(), stageSources.size(), 1, [&stageSources, &spirvs](const size_t begin, const size_t end) {
+        for(size_t i = begin; i < end; ++i)
+            spirvs[i] = RenderUtil::compileSPIR(*stageSources.at(i).second, stageSources.at(i).first, enums::RENDERING_BACKEND_BIT_VULKAN);
+    });
+
+    Vector<VkPipelineShaderStageCreateInfo> shaderStages;
+    for(size_t i = 0; i < stageSources.size(); ++i)
+        shaderStages.push_back(VKUtil::createShader(device->vkLogicalDevice(), spirvs.at(i), stageSources.at(i).first));
 
     const sp<VKGraphicsContext>& vkGraphicsContext = graphicsContext.traits().ensure<VKGraphicsContext>();
     VKGraphicsContext::State& state = vkGraphicsContext->currentState();
@@ -92,7 +92,11 @@ VkPipelineShaderStageCreateInfo VKUtil::loadShader(const VkDevice device, const
 
 VkPipelineShaderStageCreateInfo VKUtil::createShader(const VkDevice device, const String& source, const enums::ShaderStageBit stage)
 {
-    const Vector<uint32_t> spirv = RenderUtil::compileSPIR(source, stage, enums::RENDERING_BACKEND_BIT_VULKAN);
+    return createShader(device, RenderUtil::compileSPIR(source, stage, enums::RENDERING_BACKEND_BIT_VULKAN), stage);
+}
+
+VkPipelineShaderStageCreateInfo VKUtil::createShader(const VkDevice device, const Vector<uint32_t>& spirv, const enums::ShaderStageBit stage)
+{
     VkShaderModuleCreateInfo moduleCreateInfo = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
     moduleCreateInfo.codeSize = spirv.size() * sizeof(uint32_t);
     moduleCreateInfo.pCode = spirv.data();
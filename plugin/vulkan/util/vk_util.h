@@ -19,6 +19,7 @@ public:
 
     static VkPipelineShaderStageCreateInfo loadShader(VkDevice device, const String& resid, enums::ShaderStageBit stage);
     static VkPipelineShaderStageCreateInfo createShader(VkDevice device, const String& source, enums::ShaderStageBit stage);
+    static VkPipelineShaderStageCreateInfo createShader(VkDevice device, const Vector<uint32_t>& spirv, enums::ShaderStageBit stage);
 
     static void createImage(const VKDevice& device, const VkImageCreateInfo& imageCreateInfo, VkImage* image, VkDeviceMemory* memory, VkMemoryPropertyFlags propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
 
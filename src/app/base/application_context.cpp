@@ -9,6 +9,7 @@
 #include "core/impl/executor/executor_worker_thread.h"
 #include "core/impl/executor/executor_scheduled.h"
 #include "core/impl/executor/executor_thread_pool.h"
+#include "core/impl/executor/executor_work_stealing.h"
 #include "core/impl/runnable/runnable_by_function.h"
 #include "core/inf/interpreter.h"
 #include "core/inf/runnable.h"
@@ -121,10 +122,18 @@ public:
     {
     }
 
+    void onTaskDone() override
+    {
+        while(!_task_done_callbacks.empty())
+            for(const std::function<void()>& i : std::exchange(_task_done_callbacks, {}))
+                i();
+    }
+
     void onBusy() override
     {
         for(const sp<MessageLoop>& i : _message_loops)
             i->pollOnce();
+        onTaskDone();
     }
 
     void onIdle(Thread& thread) override
@@ -138,6 +147,7 @@ public:
     }
 
     U_FList<sp<MessageLoop>> _message_loops;
+    Vector<std::function<void()>> _task_done_callbacks;
 };
 
 ApplicationContext::AppClock::AppClock()
@@ -189,7 +199,10 @@ void ApplicationContext::initialize(const document& manifest)
         _interpreter = sp<Interpreter>::make<NoneInterpreter>();
 
     _core_executor = (sp<Executor>::make<ExecutorWorkerThread>(_worker_strategy, "Executor"));
-    _thread_pool_executor = (sp<Executor>::make<ExecutorThreadPool>(_core_executor));
+    if(const ApplicationManifest::ThreadPool& threadPool = ark.manifest()->threadPool(); threadPool._type == ApplicationManifest::THREAD_POOL_TYPE_WORK_STEALING)
+        _thread_pool_executor = sp<Executor>::make<ExecutorWorkStealing>(_core_executor, threadPool._capacity);
+    else
+        _thread_pool_executor = sp<Executor>::make<ExecutorThreadPool>(_core_executor, threadPool._capacity);
 
     runOnCoreThread([]() {
         __thread_init__(THREAD_NAME_ID_CORE);
@@ -199,7 +212,10 @@ void ApplicationContext::initialize(const document& manifest)
 void ApplicationContext::finalize() const
 {
     _core_executor.cast<ExecutorWorkerThread>()->terminate();
-    _thread_pool_executor.cast<ExecutorThreadPool>()->releaseAll(true);
+    if(_thread_pool_executor.getClass()->is<ExecutorWorkStealing>())
+        _thread_pool_executor.cast<ExecutorWorkStealing>()->releaseAll(true);
+    else
+        _thread_pool_executor.cast<ExecutorThreadPool>()->releaseAll(true);
     _core_executor.cast<ExecutorWorkerThread>()->tryJoin();
 }
 
@@ -413,6 +429,12 @@ void ApplicationContext::runOnCoreThread(std::function<void()> task) const
     _core_executor->execute(sp<Runnable>::make<RunnableByFunction>(std::move(task)));
 }
 
+void ApplicationContext::runAtCoreTaskEnd(std::function<void()> task) const
+{
+    THREAD_CHECK(THREAD_NAME_ID_CORE);
+    _worker_strategy->_task_done_callbacks.push_back(std::move(task));
+}
+
 void ApplicationContext::addStringBundle(const String& name, const sp<StringBundle>& stringBundle)
 {
     _string_table->addStringBundle(name, stringBundle);
@@ -69,6 +69,8 @@ public:
 
     void runOnCoreThread(sp<Runnable> task) const;
     void runOnCoreThread(std::function<void()> task) const;
+//  Core thread only. Runs the task on the core thread right after the current core task, or the current message loop poll, returns.
+    void runAtCoreTaskEnd(std::function<void()> task) const;
 
     void addStringBundle(const String& name, const sp<StringBundle>& stringBundle);
     Optional<String> getString(const String& resid, bool alert);
@@ -52,6 +52,9 @@ void ApplicationManifest::load(ark::Asset& asset)
     _heap._device_unit_size = toSize(Documents::getAttributeValue(_content, "heap/device/unit-size", "8M"));
     _heap._host_unit_size = toSize(Documents::getAttributeValue(_content, "heap/host/unit-size", "8M"));
 
+    _thread_pool._type = Documents::getAttributeValue<ThreadPoolType>(_content, "thread-pool/type", THREAD_POOL_TYPE_DEFAULT);
+    _thread_pool._capacity = Documents::getAttributeValue<uint32_t>(_content, "thread-pool/capacity", 0);
+
     _interpreter = _content->getChild("interpreter");
 
     _application._title = Documents::getAttributeValue(_content, "application/title");
@@ -102,6 +105,11 @@ const ApplicationManifest::Heap& ApplicationManifest::heap() const
     return _heap;
 }
 
+const ApplicationManifest::ThreadPool& ApplicationManifest::threadPool() const
+{
+    return _thread_pool;
+}
+
 const ApplicationManifest::Renderer& ApplicationManifest::renderer() const
 {
     return _renderer;
@@ -123,13 +131,17 @@ const document& ApplicationManifest::interpreter() const
 }
 
 ApplicationManifest::Renderer::Renderer()
-    : _backend(enums::RENDERING_BACKEND_AUTO), _version(enums::RENDERER_VERSION_AUTO), _coordinate_system(enums::COORDINATE_SYSTEM_DEFAULT), _vsync(false), _resolution(1920, 1080)
+    : _backend(enums::RENDERING_BACKEND_AUTO), _version(enums::RENDERER_VERSION_AUTO), _coordinate_system(enums::COORDINATE_SYSTEM_DEFAULT), _vsync(false), _resolution(1920, 1080), _in_flight_frames(1), _drop_stale_frames(false),
+      _parallel_compose_chunk_size(0), _texture_upload_budget(0)
 {
 }
 
 ApplicationManifest::Renderer::Renderer(const document& manifest)
     : _class(Documents::getAttribute(manifest, constants::CLASS)), _backend(Documents::getAttribute(manifest, "backend", enums::RENDERING_BACKEND_AUTO)), _version(Documents::getAttribute(manifest, "version", enums::RENDERER_VERSION_AUTO)),
-      _coordinate_system(Documents::getAttribute(manifest, "coordinate-system", enums::COORDINATE_SYSTEM_DEFAULT)), _vsync(Documents::getAttribute(manifest, "vsync", false))
+      _coordinate_system(Documents::getAttribute(manifest, "coordinate-system", enums::COORDINATE_SYSTEM_DEFAULT)), _vsync(Documents::getAttribute(manifest, "vsync", false)),
+      _in_flight_frames(std::clamp<uint32_t>(Documents::getAttribute<uint32_t>(manifest, "in-flight-frames", 1), 1, 3)), _drop_stale_frames(Documents::getAttribute(manifest, "drop-stale-frames", false)),
+      _parallel_compose_chunk_size(Documents::getAttribute<uint32_t>(manifest, "parallel-compose-chunk-size", 0)), _texture_upload_budget(Documents::getAttribute<uint32_t>(manifest, "texture-upload-budget", 0)),
+      _shader_cache(Documents::getAttribute(manifest, "shader-cache"))
 {
     if(const document& resolution = manifest->getChild("resolution"))
         _resolution = {Documents::ensureAttribute<float>(resolution, constants::WIDTH), Documents::ensureAttribute<float>(resolution, constants::HEIGHT)};
@@ -150,6 +162,15 @@ template<> ARK_API ApplicationManifest::WindowFlags StringConvert::eval<Applicat
     return ApplicationManifest::WindowFlags::toBitSet(val, windowFlags);
 }
 
+template<> ARK_API ApplicationManifest::ThreadPoolType StringConvert::eval<ApplicationManifest::ThreadPoolType>(const String& val)
+{
+    constexpr enums::LookupTable<ApplicationManifest::ThreadPoolType, 2> table = {{
+        {"default", ApplicationManifest::THREAD_POOL_TYPE_DEFAULT},
+        {"work-stealing", ApplicationManifest::THREAD_POOL_TYPE_WORK_STEALING}
+    }};
+    return enums::lookup(table, val);
+}
+
 ApplicationManifest::Asset::Asset(const document& manifest)
     : _root(Documents::getAttribute(manifest, "root", "/")), _src(Documents::getAttribute(manifest, constants::SRC))
 {
@@ -29,6 +29,11 @@ public:
         WINDOW_POSITION_CENTERED = -1
     };
 
+    enum ThreadPoolType {
+        THREAD_POOL_TYPE_DEFAULT,
+        THREAD_POOL_TYPE_WORK_STEALING
+    };
+
     struct Application {
         String _dir;
         String _filename;
@@ -56,6 +61,11 @@ public:
         uint32_t _device_unit_size;
     };
 
+    struct ThreadPool {
+        ThreadPoolType _type;
+        uint32_t _capacity;
+    };
+
     struct Renderer {
         Renderer();
         Renderer(const document& manifest);
@@ -68,6 +78,16 @@ public:
 
         bool _vsync;
         V2 _resolution;
+
+        uint32_t _in_flight_frames;
+        bool _drop_stale_frames;
+//  Elements per task when snapshotting and composing a RenderLayer on the thread pool, 0 keeps it on the calling thread.
+//  Only safe when no two renderables of one layer share mutable Variables.
+        uint32_t _parallel_compose_chunk_size;
+//  Bytes of decoded textures uploaded per frame, textures get decoded on the thread pool and show a placeholder until then. 0 decodes and uploads on the render thread.
+        uint32_t _texture_upload_budget;
+//  Directory compiled SPIR-V binaries get cached in across runs, empty compiles every shader at pipeline creation.
+        String _shader_cache;
     };
 
 public:
@@ -89,6 +109,7 @@ public:
     const V2& rendererResolution() const;
 
     const Heap& heap() const;
+    const ThreadPool& threadPool() const;
     const Renderer& renderer() const;
 
     const document& content() const;
@@ -104,6 +125,7 @@ private:
     Application _application;
     Window _window;
     Heap _heap;
+    ThreadPool _thread_pool;
     Renderer _renderer;
 
     document _content;
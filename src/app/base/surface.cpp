@@ -10,6 +10,7 @@
 #include "renderer/base/render_controller.h"
 
 #include "app/base/application_context.h"
+#include "app/base/application_manifest.h"
 
 namespace ark {
 
@@ -77,9 +78,12 @@ private:
 }
 
 Surface::Surface(sp<RenderView> renderView, const sp<ApplicationContext>& applicationContext)
-    : _render_view(std::move(renderView)), _application_context(applicationContext), _surface_controller(sp<SurfaceController>::make()), _update_requester(sp<Runnable>::make<SurfaceUpdateRequester>(_surface_controller, _application_context))
+    : _render_view(std::move(renderView)), _application_context(applicationContext),
+      _surface_controller(sp<SurfaceController>::make(Ark::instance().manifest()->renderer()._in_flight_frames, Ark::instance().manifest()->renderer()._drop_stale_frames)),
+      _update_requester(sp<Runnable>::make<SurfaceUpdateRequester>(_surface_controller, _application_context))
 {
-    requestUpdate();
+    for(uint32_t i = 0; i < _surface_controller->inFlightFrames(); ++i)
+        requestUpdate();
 }
 
 const sp<RenderView>& Surface::renderView() const
@@ -117,8 +121,9 @@ void Surface::onSurfaceChanged(const uint32_t width, const uint32_t height) cons
 void Surface::onRenderFrame(const V4& backgroundColor)
 {
     DTHREAD_CHECK(THREAD_NAME_ID_RENDERER);
-    const RenderRequest renderRequest = _surface_controller->obtainRenderRequest();
-    requestUpdate();
+    const auto [renderRequest, consumed] = _surface_controller->obtainRenderRequest();
+    for(uint32_t i = 0; i < consumed; ++i)
+        requestUpdate();
     DPROFILER_TRACE("onRenderFrame", ApplicationProfiler::CATEGORY_RENDERING);
 
     if(_screenshot_future)
@@ -0,0 +1,275 @@
+#include "app/impl/broad_phrase/broad_phrase_spatial_hash.h"
+
+#include <array>
+#include <cmath>
+
+#include "core/base/bean_factory.h"
+#include "core/util/documents.h"
+
+#include "app/inf/broad_phrase_callback.h"
+
+namespace ark {
+
+class BroadPhraseSpatialHash::Stub final : public BroadPhrase::Coordinator {
+public:
+    Stub(const int32_t dimension, const V3& cell)
+        : _dimension(dimension), _cell_size(cell), _epoch(0)
+    {
+        CHECK(_dimension == 2 || _dimension == 3, "Dimension should be either 2(V2) or 3(V3)");
+        for(int32_t i = 0; i < _dimension; ++i)
+            CHECK(_cell_size[i] > 0, "Cell size must be positive, got %.2f on axis %d", _cell_size[i], i);
+    }
+
+    void create(const RefId id, const V3& position, const V3& size) override
+    {
+        uint32_t slot;
+        if(_free_slots.empty())
+        {
+            slot = static_cast<uint32_t>(_trackees.size());
+            _trackees.emplace_back();
+        }
+        else
+        {
+            slot = _free_slots.back();
+            _free_slots.pop_back();
+        }
+        _slots[id] = slot;
+
+        Trackee& trackee = _trackees[slot];
+        trackee._id = id;
+        trackee._stamp = 0;
+        setBounds(trackee, position, size);
+        toCellRange(trackee._lower, trackee._upper, trackee._cell_begin, trackee._cell_end);
+        forEachCell(trackee._cell_begin, trackee._cell_end, [this, slot](const uint64_t key) {
+            ensureCell(key).push_back(slot);
+        });
+    }
+
+    void update(const RefId id, const V3& position, const V3& size) override
+    {
+        const auto iter = _slots.find(id);
+        if(iter == _slots.end())
+        {
+            create(id, position, size);
+            return;
+        }
+
+        const uint32_t slot = iter->second;
+        Trackee& trackee = _trackees[slot];
+        setBounds(trackee, position, size);
+
+        CellCoord cellBegin, cellEnd;
+        toCellRange(trackee._lower, trackee._upper, cellBegin, cellEnd);
+        if(cellBegin == trackee._cell_begin && cellEnd == trackee._cell_end)
+            return;
+
+        forEachCell(trackee._cell_begin, trackee._cell_end, [this, slot, &cellBegin, &cellEnd](const uint64_t key) {
+            if(!contains(cellBegin, cellEnd, fromKey(key)))
+                eraseFromCell(key, slot);
+        });
+        forEachCell(cellBegin, cellEnd, [this, slot, &trackee](const uint64_t key) {
+            if(!contains(trackee._cell_begin, trackee._cell_end, fromKey(key)))
+                ensureCell(key).push_back(slot);
+        });
+        trackee._cell_begin = cellBegin;
+        trackee._cell_end = cellEnd;
+    }
+
+    void remove(const RefId id) override
+    {
+        const auto iter = _slots.find(id);
+        if(iter == _slots.end())
+            return;
+
+        const uint32_t slot = iter->second;
+        Trackee& trackee = _trackees[slot];
+        forEachCell(trackee._cell_begin, trackee._cell_end, [this, slot](const uint64_t key) {
+            eraseFromCell(key, slot);
+        });
+        _free_slots.push_back(slot);
+        _slots.erase(iter);
+    }
+
+    void search(BroadPhraseCallback& callback, const V3& position, const V3& size)
+    {
+        V3 lower, upper;
+        for(int32_t i = 0; i < 3; ++i)
+        {
+            lower[i] = position[i] - size[i] / 2.0f;
+            upper[i] = position[i] + size[i] / 2.0f;
+        }
+
+        CellCoord cellBegin, cellEnd;
+        toCellRange(lower, upper, cellBegin, cellEnd);
+        const uint32_t epoch = nextEpoch();
+
+//      Callbacks may re-enter the broad phase, so candidates are collected first. A nested search gets a fresh buffer.
+        Vector<RefId> candidates = std::move(_candidates);
+        candidates.clear();
+        forEachCell(cellBegin, cellEnd, [this, epoch, &lower, &upper, &candidates](const uint64_t key) {
+            const auto iter = _cell_indices.find(key);
+            if(iter == _cell_indices.end())
+                return;
+            for(const uint32_t i : _cells[iter->second])
+                if(Trackee& trackee = _trackees[i]; trackee._stamp != epoch)
+                {
+                    trackee._stamp = epoch;
+                    if(overlaps(trackee, lower, upper))
+                        candidates.push_back(trackee._id);
+                }
+        });
+
+        for(const RefId i : candidates)
+            callback.onRigidbodyCandidate(i);
+        _candidates = std::move(candidates);
+    }
+
+private:
+    typedef std::array<int32_t, 3> CellCoord;
+
+    struct Trackee {
+        RefId _id = 0;
+        uint32_t _stamp = 0;
+        V3 _lower;
+        V3 _upper;
+        CellCoord _cell_begin = {};
+        CellCoord _cell_end = {};
+    };
+
+    void setBounds(Trackee& trackee, const V3& position, const V3& size) const
+    {
+        for(int32_t i = 0; i < 3; ++i)
+        {
+            trackee._lower[i] = position[i] - size[i] / 2.0f;
+            trackee._upper[i] = position[i] + size[i] / 2.0f;
+        }
+    }
+
+    bool overlaps(const Trackee& trackee, const V3& lower, const V3& upper) const
+    {
+        for(int32_t i = 0; i < _dimension; ++i)
+            if(trackee._upper[i] < lower[i] || trackee._lower[i] > upper[i])
+                return false;
+        return true;
+    }
+
+    void toCellRange(const V3& lower, const V3& upper, CellCoord& cellBegin, CellCoord& cellEnd) const
+    {
+        for(int32_t i = 0; i < 3; ++i)
+        {
+            cellBegin[i] = i < _dimension ? static_cast<int32_t>(std::floor(lower[i] / _cell_size[i])) : 0;
+            cellEnd[i] = i < _dimension ? static_cast<int32_t>(std::floor(upper[i] / _cell_size[i])) : 0;
+        }
+    }
+
+    template<typename F> static void forEachCell(const CellCoord& cellBegin, const CellCoord& cellEnd, F func)
+    {
+        for(int32_t z = cellBegin[2]; z <= cellEnd[2]; ++z)
+            for(int32_t y = cellBegin[1]; y <= cellEnd[1]; ++y)
+                for(int32_t x = cellBegin[0]; x <= cellEnd[0]; ++x)
+                    func(toKey({x, y, z}));
+    }
+
+    static bool contains(const CellCoord& cellBegin, const CellCoord& cellEnd, const CellCoord& coord)
+    {
+        for(int32_t i = 0; i < 3; ++i)
+            if(coord[i] < cellBegin[i] || coord[i] > cellEnd[i])
+                return false;
+        return true;
+    }
+
+//  21 bits per axis, enough for ±1M cells in each direction.
+    static uint64_t toKey(const CellCoord& coord)
+    {
+        constexpr uint64_t mask = (1ull << 21) - 1;
+        return (static_cast<uint64_t>(coord[0]) & mask) | (static_cast<uint64_t>(coord[1]) & mask) << 21 | (static_cast<uint64_t>(coord[2]) & mask) << 42;
+    }
+
+    static CellCoord fromKey(const uint64_t key)
+    {
+        constexpr uint64_t mask = (1ull << 21) - 1;
+        const auto signExtend = [](const uint64_t v) {
+            return static_cast<int32_t>(static_cast<int64_t>(v << 43) >> 43);
+        };
+        return {signExtend(key & mask), signExtend(key >> 21 & mask), signExtend(key >> 42 & mask)};
+    }
+
+    Vector<uint32_t>& ensureCell(const uint64_t key)
+    {
+        const auto [iter, inserted] = _cell_indices.try_emplace(key, static_cast<uint32_t>(_cells.size()));
+        if(inserted)
+            _cells.emplace_back();
+        return _cells[iter->second];
+    }
+
+    void eraseFromCell(const uint64_t key, const uint32_t slot)
+    {
+        const auto iter = _cell_indices.find(key);
+        DCHECK(iter != _cell_indices.end(), "Cell %llx not found", key);
+        Vector<uint32_t>& cell = _cells[iter->second];
+        for(size_t i = 0; i < cell.size(); ++i)
+            if(cell[i] == slot)
+            {
+                cell[i] = cell.back();
+                cell.pop_back();
+                break;
+            }
+    }
+
+    uint32_t nextEpoch()
+    {
+        if(++_epoch == 0)
+        {
+            for(Trackee& i : _trackees)
+                i._stamp = 0;
+            _epoch = 1;
+        }
+        return _epoch;
+    }
+
+private:
+    int32_t _dimension;
+    V3 _cell_size;
+
+    Vector<Trackee> _trackees;
+    Vector<uint32_t> _free_slots;
+    HashMap<RefId, uint32_t> _slots;
+
+    HashMap<uint64_t, uint32_t> _cell_indices;
+    Vector<Vector<uint32_t>> _cells;
+
+    uint32_t _epoch;
+    Vector<RefId> _candidates;
+};
+
+BroadPhraseSpatialHash::BroadPhraseSpatialHash(const int32_t dimension, const V3& cell)
+    : _stub(sp<Stub>::make(dimension, cell))
+{
+}
+
+sp<BroadPhrase::Coordinator> BroadPhraseSpatialHash::requestCoordinator()
+{
+    return _stub.cast<Coordinator>();
+}
+
+void BroadPhraseSpatialHash::search(BroadPhraseCallback& callback, const V3 position, const V3 size)
+{
+    _stub->search(callback, position, size);
+}
+
+void BroadPhraseSpatialHash::rayCast(BroadPhraseCallback& callback, const V3 from, const V3 to, const sp<CollisionFilter>& /*collisionFilter*/)
+{
+    search(callback, (from + to) / 2, V3(std::abs(from.x() - to.x()), std::abs(from.y() - to.y()), std::abs(from.z() - to.z())));
+}
+
+BroadPhraseSpatialHash::BUILDER::BUILDER(BeanFactory& factory, const document& manifest)
+    : _dimension(Documents::getAttribute<int32_t>(manifest, "dimension", 2)), _cell(factory.ensureBuilder<Vec3>(manifest, "cell"))
+{
+}
+
+sp<BroadPhrase> BroadPhraseSpatialHash::BUILDER::build(const Scope& args)
+{
+    return sp<BroadPhrase>::make<BroadPhraseSpatialHash>(_dimension, _cell->build(args)->val());
+}
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "core/inf/builder.h"
+#include "core/types/shared_ptr.h"
+
+#include "graphics/forwarding.h"
+#include "graphics/base/v3.h"
+
+#include "app/inf/broad_phrase.h"
+
+namespace ark {
+
+//  Uniform grid hashed by cell coordinates. Every cell keeps a dense array of the slots overlapping it, and cells are never
+//  released, so steady-state updates and queries don't touch the heap. Queries de-duplicate by stamping slots with an epoch.
+class BroadPhraseSpatialHash final : public BroadPhrase {
+public:
+    BroadPhraseSpatialHash(int32_t dimension, const V3& cell);
+
+    sp<Coordinator> requestCoordinator() override;
+
+    void search(BroadPhraseCallback& callback, V3 position, V3 size) override;
+    void rayCast(BroadPhraseCallback& callback, V3 from, V3 to, const sp<CollisionFilter>& collisionFilter) override;
+
+    class Stub;
+
+//  [[plugin::builder("broad-phrase-spatial-hash")]]
+    class BUILDER final : public Builder<BroadPhrase> {
+    public:
+        BUILDER(BeanFactory& factory, const document& manifest);
+
+        sp<BroadPhrase> build(const Scope& args) override;
+
+    private:
+        int32_t _dimension;
+        sp<Builder<Vec3>> _cell;
+    };
+
+private:
+    sp<Stub> _stub;
+};
+
+}
@@ -0,0 +1,351 @@
+#include "app/impl/broad_phrase/broad_phrase_sweep_and_prune.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "core/base/bean_factory.h"
+#include "core/util/documents.h"
+
+#include "app/inf/broad_phrase_callback.h"
+
+namespace ark {
+
+class BroadPhraseSweepAndPrune::Stub final : public BroadPhrase::Coordinator {
+public:
+    Stub(const int32_t dimension)
+        : _dimension(dimension)
+    {
+        CHECK(_dimension == 2 || _dimension == 3, "Dimension should be either 2(V2) or 3(V3)");
+    }
+
+    void create(const RefId id, const V3& position, const V3& size) override
+    {
+        if(_slots.contains(id))
+            return update(id, position, size);
+
+        uint32_t slot;
+        if(_free_slots.empty())
+        {
+            slot = static_cast<uint32_t>(_boxes.size());
+            _boxes.emplace_back();
+        }
+        else
+        {
+            slot = _free_slots.back();
+            _free_slots.pop_back();
+        }
+        _slots[id] = slot;
+
+        Box& box = _boxes[slot];
+        box._id = id;
+        box._alive = true;
+        setBounds(box, position, size);
+        updateMaxExtents(box);
+        for(int32_t i = 0; i < _dimension; ++i)
+        {
+            Vector<Endpoint>& endpoints = _axes[i];
+            box._endpoints[i][0] = static_cast<uint32_t>(endpoints.size());
+            endpoints.push_back({box._lower[i], slot, false});
+            box._endpoints[i][1] = static_cast<uint32_t>(endpoints.size());
+            endpoints.push_back({box._upper[i], slot, true});
+            sortDown(i, box._endpoints[i][0]);
+            sortDown(i, box._endpoints[i][1]);
+        }
+    }
+
+    void update(const RefId id, const V3& position, const V3& size) override
+    {
+        const auto iter = _slots.find(id);
+        if(iter == _slots.end())
+            return create(id, position, size);
+
+        const uint32_t slot = iter->second;
+        Box& box = _boxes[slot];
+        const V3 lower = box._lower;
+        const V3 upper = box._upper;
+        setBounds(box, position, size);
+        updateMaxExtents(box);
+        for(int32_t i = 0; i < _dimension; ++i)
+        {
+//          Grow before shrinking so that a box never transiently inverts on an axis.
+            if(box._lower[i] < lower[i])
+                moveEndpoint(i, box._endpoints[i][0], box._lower[i]);
+            if(box._upper[i] > upper[i])
+                moveEndpoint(i, box._endpoints[i][1], box._upper[i]);
+            if(box._lower[i] > lower[i])
+                moveEndpoint(i, box._endpoints[i][0], box._lower[i]);
+            if(box._upper[i] < upper[i])
+                moveEndpoint(i, box._endpoints[i][1], box._upper[i]);
+        }
+    }
+
+    void remove(const RefId id) override
+    {
+        const auto iter = _slots.find(id);
+        if(iter == _slots.end())
+            return;
+
+        const uint32_t slot = iter->second;
+        Box& box = _boxes[slot];
+        while(!box._overlaps.empty())
+            removePair(slot, box._overlaps.back());
+
+        box._alive = false;
+        for(int32_t i = 0; i < _dimension; ++i)
+        {
+            Vector<Endpoint>& endpoints = _axes[i];
+            moveEndpoint(i, box._endpoints[i][1], std::numeric_limits<float>::infinity());
+            moveEndpoint(i, box._endpoints[i][0], std::numeric_limits<float>::infinity());
+            DASSERT(endpoints.back()._slot == slot && endpoints[endpoints.size() - 2]._slot == slot);
+            endpoints.resize(endpoints.size() - 2);
+        }
+        _free_slots.push_back(slot);
+        _slots.erase(iter);
+    }
+
+    void search(BroadPhraseCallback& callback, const V3& position, const V3& size)
+    {
+        V3 lower, upper;
+        for(int32_t i = 0; i < 3; ++i)
+        {
+            lower[i] = position[i] - size[i] / 2.0f;
+            upper[i] = position[i] + size[i] / 2.0f;
+        }
+
+//      A box reaching into the query starts at most one extent before it, so the scan starts there instead of at the first endpoint.
+        const Vector<Endpoint>& endpoints = _axes[0];
+        const float from = lower[0] - _max_extents[0];
+        Vector<RefId> candidates = std::move(_candidates);
+        candidates.clear();
+        for(auto iter = std::lower_bound(endpoints.begin(), endpoints.end(), from, [](const Endpoint& endpoint, const float value) { return endpoint._value < value; });
+            iter != endpoints.end() && iter->_value <= upper[0]; ++iter)
+            if(const Box& box = _boxes[iter->_slot]; !iter->_is_upper && overlaps(box, lower, upper))
+                candidates.push_back(box._id);
+        dispatch(callback, candidates);
+    }
+
+    bool searchOverlaps(BroadPhraseCallback& callback, const RefId id)
+    {
+        const auto iter = _slots.find(id);
+        if(iter == _slots.end())
+            return false;
+
+        Vector<RefId> candidates = std::move(_candidates);
+        candidates.clear();
+        for(const uint32_t i : _boxes[iter->second]._overlaps)
+            candidates.push_back(_boxes[i]._id);
+        dispatch(callback, candidates);
+        return true;
+    }
+
+    sp<PairListener> _pair_listener;
+
+private:
+    struct Endpoint {
+//      Lower endpoints sort first on ties, so touching boxes count as overlapping just like overlaps() does.
+        bool operator <(const Endpoint& other) const {
+            return _value < other._value || (_value == other._value && !_is_upper && other._is_upper);
+        }
+
+        float _value;
+        uint32_t _slot;
+        bool _is_upper;
+    };
+
+    struct Box {
+        RefId _id = 0;
+        bool _alive = false;
+        V3 _lower;
+        V3 _upper;
+        uint32_t _endpoints[3][2] = {};
+        Vector<uint32_t> _overlaps;
+    };
+
+    void setBounds(Box& box, const V3& position, const V3& size) const
+    {
+        for(int32_t i = 0; i < 3; ++i)
+        {
+            box._lower[i] = position[i] - size[i] / 2.0f;
+            box._upper[i] = position[i] + size[i] / 2.0f;
+        }
+    }
+
+//  Extents only ever grow, a stale maximum just makes search() scan a few more endpoints.
+    void updateMaxExtents(const Box& box)
+    {
+        for(int32_t i = 0; i < _dimension; ++i)
+            _max_extents[i] = std::max(_max_extents[i], box._upper[i] - box._lower[i]);
+    }
+
+    bool overlaps(const Box& box, const V3& lower, const V3& upper) const
+    {
+        for(int32_t i = 0; i < _dimension; ++i)
+            if(box._upper[i] < lower[i] || box._lower[i] > upper[i])
+                return false;
+        return true;
+    }
+
+    bool overlaps(const uint32_t a, const uint32_t b) const
+    {
+        const Box& boxA = _boxes[a];
+        const Box& boxB = _boxes[b];
+        return boxA._alive && boxB._alive && overlaps(boxA, boxB._lower, boxB._upper);
+    }
+
+    void moveEndpoint(const int32_t axis, const uint32_t index, const float value)
+    {
+        Endpoint& endpoint = _axes[axis][index];
+        const float previous = endpoint._value;
+        endpoint._value = value;
+        if(value < previous)
+            sortDown(axis, index);
+        else
+            sortUp(axis, index);
+    }
+
+    void sortDown(const int32_t axis, uint32_t index)
+    {
+        Vector<Endpoint>& endpoints = _axes[axis];
+        while(index > 0 && endpoints[index] < endpoints[index - 1])
+        {
+            const Endpoint& moving = endpoints[index];
+            const Endpoint& other = endpoints[index - 1];
+            if(!moving._is_upper && other._is_upper)
+            {
+                if(overlaps(moving._slot, other._slot))
+                    addPair(moving._slot, other._slot);
+            }
+            else if(moving._is_upper && !other._is_upper)
+                removePair(moving._slot, other._slot);
+            swapEndpoints(axis, index - 1, index);
+            --index;
+        }
+    }
+
+    void sortUp(const int32_t axis, uint32_t index)
+    {
+        Vector<Endpoint>& endpoints = _axes[axis];
+        while(index + 1 < endpoints.size() && endpoints[index + 1] < endpoints[index])
+        {
+            const Endpoint& moving = endpoints[index];
+            const Endpoint& other = endpoints[index + 1];
+            if(moving._is_upper && !other._is_upper)
+            {
+                if(overlaps(moving._slot, other._slot))
+                    addPair(moving._slot, other._slot);
+            }
+            else if(!moving._is_upper && other._is_upper)
+                removePair(moving._slot, other._slot);
+            swapEndpoints(axis, index, index + 1);
+            ++index;
+        }
+    }
+
+    void swapEndpoints(const int32_t axis, const uint32_t a, const uint32_t b)
+    {
+        Vector<Endpoint>& endpoints = _axes[axis];
+        std::swap(endpoints[a], endpoints[b]);
+        _boxes[endpoints[a]._slot]._endpoints[axis][endpoints[a]._is_upper ? 1 : 0] = a;
+        _boxes[endpoints[b]._slot]._endpoints[axis][endpoints[b]._is_upper ? 1 : 0] = b;
+    }
+
+    void addPair(const uint32_t a, const uint32_t b)
+    {
+        if(a == b || !_pairs.insert(toPairKey(a, b)).second)
+            return;
+
+        _boxes[a]._overlaps.push_back(b);
+        _boxes[b]._overlaps.push_back(a);
+        if(_pair_listener)
+            _pair_listener->onBeginOverlap(_boxes[a]._id, _boxes[b]._id);
+    }
+
+    void removePair(const uint32_t a, const uint32_t b)
+    {
+        if(a == b || _pairs.erase(toPairKey(a, b)) == 0)
+            return;
+
+        eraseOverlap(_boxes[a]._overlaps, b);
+        eraseOverlap(_boxes[b]._overlaps, a);
+        if(_pair_listener)
+            _pair_listener->onEndOverlap(_boxes[a]._id, _boxes[b]._id);
+    }
+
+    static void eraseOverlap(Vector<uint32_t>& overlaps, const uint32_t slot)
+    {
+        for(uint32_t& i : overlaps)
+            if(i == slot)
+            {
+                i = overlaps.back();
+                overlaps.pop_back();
+                break;
+            }
+    }
+
+    static uint64_t toPairKey(const uint32_t a, const uint32_t b)
+    {
+        return a < b ? static_cast<uint64_t>(a) << 32 | b : static_cast<uint64_t>(b) << 32 | a;
+    }
+
+//  Callbacks may re-enter the broad phase, so candidates are collected first. A nested search gets a fresh buffer.
+    void dispatch(BroadPhraseCallback& callback, Vector<RefId>& candidates)
+    {
+        for(const RefId i : candidates)
+            callback.onRigidbodyCandidate(i);
+        _candidates = std::move(candidates);
+    }
+
+private:
+    int32_t _dimension;
+
+    Vector<Endpoint> _axes[3];
+    float _max_extents[3] = {};
+    Vector<Box> _boxes;
+    Vector<uint32_t> _free_slots;
+    HashMap<RefId, uint32_t> _slots;
+    HashSet<uint64_t> _pairs;
+
+    Vector<RefId> _candidates;
+};
+
+BroadPhraseSweepAndPrune::BroadPhraseSweepAndPrune(const int32_t dimension)
+    : _stub(sp<Stub>::make(dimension))
+{
+}
+
+sp<BroadPhrase::Coordinator> BroadPhraseSweepAndPrune::requestCoordinator()
+{
+    return _stub.cast<Coordinator>();
+}
+
+void BroadPhraseSweepAndPrune::search(BroadPhraseCallback& callback, const V3 position, const V3 size)
+{
+    _stub->search(callback, position, size);
+}
+
+bool BroadPhraseSweepAndPrune::searchOverlaps(BroadPhraseCallback& callback, const RefId id)
+{
+    return _stub->searchOverlaps(callback, id);
+}
+
+void BroadPhraseSweepAndPrune::rayCast(BroadPhraseCallback& callback, const V3 from, const V3 to, const sp<CollisionFilter>& /*collisionFilter*/)
+{
+    search(callback, (from + to) / 2, V3(std::abs(from.x() - to.x()), std::abs(from.y() - to.y()), std::abs(from.z() - to.z())));
+}
+
+void BroadPhraseSweepAndPrune::setPairListener(sp<PairListener> pairListener)
+{
+    _stub->_pair_listener = std::move(pairListener);
+}
+
+BroadPhraseSweepAndPrune::BUILDER::BUILDER(BeanFactory& /*factory*/, const document& manifest)
+    : _dimension(Documents::getAttribute<int32_t>(manifest, "dimension", 2))
+{
+}
+
+sp<BroadPhrase> BroadPhraseSweepAndPrune::BUILDER::build(const Scope& /*args*/)
+{
+    return sp<BroadPhrase>::make<BroadPhraseSweepAndPrune>(_dimension);
+}
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "core/inf/builder.h"
+#include "core/types/shared_ptr.h"
+
+#include "graphics/forwarding.h"
+#include "graphics/base/v3.h"
+
+#include "app/inf/broad_phrase.h"
+
+namespace ark {
+
+//  Incremental sweep-and-prune: endpoints stay sorted per axis and are moved with insertion sort on every update, so a
+//  frame where few bodies moved costs close to O(n + moved). Overlapping pairs are tracked persistently as endpoints cross.
+class BroadPhraseSweepAndPrune final : public BroadPhrase {
+public:
+    BroadPhraseSweepAndPrune(int32_t dimension);
+
+    sp<Coordinator> requestCoordinator() override;
+
+    void search(BroadPhraseCallback& callback, V3 position, V3 size) override;
+    bool searchOverlaps(BroadPhraseCallback& callback, RefId id) override;
+    void rayCast(BroadPhraseCallback& callback, V3 from, V3 to, const sp<CollisionFilter>& collisionFilter) override;
+
+    void setPairListener(sp<PairListener> pairListener) override;
+
+//  [[plugin::builder("broad-phrase-sweep-and-prune")]]
+    class BUILDER final : public Builder<BroadPhrase> {
+    public:
+        BUILDER(BeanFactory& factory, const document& manifest);
+
+        sp<BroadPhrase> build(const Scope& args) override;
+
+    private:
+        int32_t _dimension;
+    };
+
+    class Stub;
+
+private:
+    sp<Stub> _stub;
+};
+
+}
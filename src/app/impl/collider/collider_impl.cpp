@@ -8,6 +8,7 @@
 #include "core/types/global.h"
 #include "core/types/ref.h"
 #include "core/util/log.h"
+#include "core/util/parallel_util.h"
 
 #include "../../../graphics/base/shape.h"
 #include "graphics/components/size.h"
@@ -15,6 +16,7 @@
 
 #include "renderer/base/resource_loader_context.h"
 
+#include "app/base/application_context.h"
 #include "app/base/collision_filter.h"
 #include "app/base/collision_manifold.h"
 #include "app/base/raycast_manifold.h"
@@ -44,6 +46,19 @@ float calcOccupyRadius(const Shape& shape)
 
 }
 
+struct ColliderImpl::CollisionBody {
+    RigidbodyImpl* _rigidbody;
+    BroadPhrase::Candidate _candidate;
+};
+
+struct ColliderImpl::CollisionTest {
+    uint32_t _body_index;
+    BroadPhrase::Candidate _candidate;
+    bool _is_static;
+    bool _collided = false;
+    CollisionManifold _manifold;
+};
+
 class ColliderImpl::RigidbodyImpl final : public RigidbodyController {
 public:
     RigidbodyImpl(const Stub& stub, Rigidbody::BodyType type, sp<Shape> shape, sp<Vec3> position, sp<Vec4> rotation, sp<CollisionFilter> collisionFilter, sp<Boolean> discarded)
@@ -66,13 +81,15 @@ public:
         return false;
     }
 
-    void collisionTest(Stub& collider, const V3& position, const V3& size, const Set<RefId>& removingIds)
+    void gatherCollisionTests(Stub& collider, const Set<RefId>& removingIds, Vector<CollisionBody>& bodies, Vector<CollisionTest>& tests)
     {
         if(_rigidbody_stub->_ref->isDiscarded())
             return doDiscard(collider);
 
-        BroadPhraseCallbackCollisionTest broadPhraseCallback(collider, *this, removingIds);
-        collider.broadPhraseSearch(broadPhraseCallback, position, size, _rigidbody_stub->_collision_filter);
+        BroadPhraseCallbackGather broadPhraseCallback(*this, removingIds, static_cast<uint32_t>(bodies.size()), tests);
+        bodies.push_back({this, toBroadPhraseCandidate()});
+        const float r = _occupy_radius;
+        collider.broadPhraseSearch(broadPhraseCallback, _rigidbody_stub->_ref->id(), _rigidbody_stub->_position.val(), V3(r * 2), _rigidbody_stub->_collision_filter);
     }
 
     void doDiscard(Stub& stub) const
@@ -214,58 +231,74 @@ public:
 
     float _occupy_radius;
 
-    class BroadPhraseCallbackCollisionTest final : public BroadPhraseCallback {
+    class BroadPhraseCallbackGather final : public BroadPhraseCallback {
     public:
-        BroadPhraseCallbackCollisionTest(ColliderImpl::Stub& collider, RigidbodyImpl& rigidbody, const Set<RefId>& removingIds)
-            : _collider(collider), _rigidbody(rigidbody), _removing_ids(removingIds), _self(rigidbody.makeShadow()), _candidate_self(rigidbody.toBroadPhraseCandidate()), _narrow_phrase(_collider.narrowPhrase()),
-              _dynamic_contacts(std::move(rigidbody._dynamic_contacts)), _static_contacts(std::move(rigidbody._static_contacts))
+        BroadPhraseCallbackGather(const RigidbodyImpl& rigidbody, const Set<RefId>& removingIds, const uint32_t bodyIndex, Vector<CollisionTest>& tests)
+            : _self_id(rigidbody._rigidbody_stub->_ref->id()), _removing_ids(removingIds), _body_index(bodyIndex), _tests(tests)
         {
         }
-        ~BroadPhraseCallbackCollisionTest() override
-        {
-            collisionTestDone(_dynamic_contacts, _dynamic_contacts_out);
-            collisionTestDone(_static_contacts, _static_contacts_out);
-            _rigidbody._dynamic_contacts = std::move(_dynamic_contacts_out);
-            _rigidbody._static_contacts = std::move(_static_contacts_out);
-        }
 
         void onRigidbodyCandidate(const RefId rigidbodyId) override
         {
-            if(rigidbodyId != _self.id() && !_removing_ids.contains(rigidbodyId))
+            if(rigidbodyId != _self_id && !_removing_ids.contains(rigidbodyId))
             {
                 const RefManager& refManager = Global<RefManager>();
                 const RigidbodyImpl& rigidBody = refManager.toRef(rigidbodyId)->instance<RigidbodyImpl>();
-                collisionTestOne(rigidBody.toBroadPhraseCandidate(), _dynamic_contacts, _dynamic_contacts_out);
+                _tests.push_back({_body_index, rigidBody.toBroadPhraseCandidate(), false});
             }
         }
 
         void onStaticCandidate(const RefId candidateId, const V3 position, const V4 quaternion, sp<Shape> shape, sp<CollisionFilter> collisionFilter) override
         {
-            collisionTestOne({candidateId, position, quaternion, std::move(shape), std::move(collisionFilter)}, _static_contacts, _static_contacts_out);
+            _tests.push_back({_body_index, {candidateId, position, quaternion, std::move(shape), std::move(collisionFilter)}, true});
         }
 
-        void collisionTestOne(const BroadPhrase::Candidate& candidate, Set<RefId>& contacts, Set<RefId>& contactsOut) const
+    private:
+        RefId _self_id;
+        const Set<RefId>& _removing_ids;
+        uint32_t _body_index;
+        Vector<CollisionTest>& _tests;
+    };
+
+    class ContactDispatcher {
+    public:
+        ContactDispatcher(const ColliderImpl::Stub& collider, RigidbodyImpl& rigidbody)
+            : _collider(collider), _rigidbody(rigidbody), _self(rigidbody.makeShadow()), _dynamic_contacts(std::move(rigidbody._dynamic_contacts)), _static_contacts(std::move(rigidbody._static_contacts))
         {
-            const RefManager& refManager = Global<RefManager>();
-            CollisionManifold manifold;
-            if(_narrow_phrase->collisionManifold(_candidate_self, candidate, manifold))
+        }
+        ~ContactDispatcher()
+        {
+            collisionTestDone(_dynamic_contacts, _dynamic_contacts_out);
+            collisionTestDone(_static_contacts, _static_contacts_out);
+            _rigidbody._dynamic_contacts = std::move(_dynamic_contacts_out);
+            _rigidbody._static_contacts = std::move(_static_contacts_out);
+        }
+
+        void dispatch(const CollisionTest& test)
+        {
+            if(!test._collided)
+                return;
+
+            Set<RefId>& contacts = test._is_static ? _static_contacts : _dynamic_contacts;
+            Set<RefId>& contactsOut = test._is_static ? _static_contacts_out : _dynamic_contacts_out;
+            const RefId candidateId = test._candidate._id;
+            if(const auto iter = contacts.find(candidateId); iter == contacts.end())
             {
-                if(const auto iter = contacts.find(candidate._id); iter == contacts.end())
+                const RefManager& refManager = Global<RefManager>();
+                if(const Ref& ref = refManager.toRef(candidateId))
                 {
-                    if(const Ref& ref = refManager.toRef(candidate._id))
-                    {
-                        const Rigidbody other = ref.instance<RigidbodyImpl>().makeShadow();
-                        _self.onBeginContact(other, manifold);
-                        if(!_collider._dirty_rigid_body_refs.contains(&ref))
-                            other.onBeginContact(_self, {manifold.contactPoint(), -manifold.normal()});
-                    }
+                    const Rigidbody other = ref.instance<RigidbodyImpl>().makeShadow();
+                    _self.onBeginContact(other, test._manifold);
+                    if(!_collider._dirty_rigid_body_refs.contains(&ref))
+                        other.onBeginContact(_self, {test._manifold.contactPoint(), -test._manifold.normal()});
                 }
-                else
-                    contacts.erase(iter);
-                contactsOut.insert(candidate._id);
             }
+            else
+                contacts.erase(iter);
+            contactsOut.insert(candidateId);
         }
 
+    private:
         void collisionTestDone(const Set<RefId>& contacts, const Set<RefId>& contactsOut) const
         {
             const RefManager& refManager = Global<RefManager>();
@@ -282,13 +315,11 @@ public:
             }
         }
 
-        ColliderImpl::Stub& _collider;
+    private:
+        const ColliderImpl::Stub& _collider;
         RigidbodyImpl& _rigidbody;
-        const Set<RefId>& _removing_ids;
 
         Rigidbody _self;
-        BroadPhrase::Candidate _candidate_self;
-        sp<NarrowPhrase> _narrow_phrase;
 
         Set<RefId> _dynamic_contacts;
         Set<RefId> _dynamic_contacts_out;
@@ -299,8 +330,23 @@ public:
 
 };
 
-ColliderImpl::ColliderImpl(Vector<std::pair<sp<BroadPhrase>, sp<CollisionFilter>>> broadPhrases, sp<NarrowPhrase> narrowPhrase, RenderController& renderController)
-    : _stub(sp<Stub>::make(std::move(broadPhrases), std::move(narrowPhrase)))
+//  Collects the pairs the broad phases stop reporting as overlapping. Overlaps that begin are found by the searchOverlaps() of the body that moved.
+class ColliderImpl::PairTracker final : public BroadPhrase::PairListener {
+public:
+    void onBeginOverlap(RefId /*a*/, RefId /*b*/) override
+    {
+    }
+
+    void onEndOverlap(const RefId a, const RefId b) override
+    {
+        _ended.emplace_back(a, b);
+    }
+
+    Vector<std::pair<RefId, RefId>> _ended;
+};
+
+ColliderImpl::ColliderImpl(Vector<std::pair<sp<BroadPhrase>, sp<CollisionFilter>>> broadPhrases, sp<NarrowPhrase> narrowPhrase, RenderController& renderController, const uint32_t narrowPhraseChunkSize)
+    : _stub(sp<Stub>::make(std::move(broadPhrases), std::move(narrowPhrase), narrowPhraseChunkSize))
 {
     renderController.addPreComposeUpdatable(_stub, sp<Boolean>::make<BooleanByWeakRef<Stub>>(_stub, 1));
 }
@@ -329,18 +375,68 @@ Vector<RayCastManifold> ColliderImpl::rayCast(const V3 from, const V3 to, const
     return _stub->rayCast(from, to, collisionFilter);
 }
 
-ColliderImpl::Stub::Stub(Vector<std::pair<sp<BroadPhrase>, sp<CollisionFilter>>> broadPhrases, sp<NarrowPhrase> narrowPhrase)
-    : _broad_phrases(std::move(broadPhrases)), _narrow_phrase(std::move(narrowPhrase))
+ColliderImpl::Stub::Stub(Vector<std::pair<sp<BroadPhrase>, sp<CollisionFilter>>> broadPhrases, sp<NarrowPhrase> narrowPhrase, const uint32_t narrowPhraseChunkSize)
+    : _broad_phrases(std::move(broadPhrases)), _narrow_phrase(std::move(narrowPhrase)), _pair_tracker(sp<PairTracker>::make()), _narrow_phrase_chunk_size(narrowPhraseChunkSize)
 {
+    for(const auto& i : _broad_phrases | std::views::keys)
+        i->setPairListener(_pair_tracker);
+    if(_narrow_phrase_chunk_size)
+        _narrow_phrase_executor = Ark::instance().applicationContext()->threadPoolExecutor();
 }
 
-void ColliderImpl::Stub::broadPhraseSearch(BroadPhraseCallback& callback, const V3 position, const V3 size, const sp<CollisionFilter>& collisionFilter) const
+ColliderImpl::Stub::~Stub() = default;
+
+void ColliderImpl::Stub::broadPhraseSearch(BroadPhraseCallback& callback, const RefId id, const V3 position, const V3 size, const sp<CollisionFilter>& collisionFilter) const
 {
     for(const auto& [i, j] : _broad_phrases)
-        if(collisionFilterTest(j, collisionFilter))
+        if(collisionFilterTest(j, collisionFilter) && !i->searchOverlaps(callback, id))
             i->search(callback, position, size);
 }
 
+void ColliderImpl::Stub::narrowPhraseTest(const Vector<CollisionBody>& bodies, Vector<CollisionTest>& tests) const
+{
+    DPROFILER_TRACE("NarrowPhrase", ApplicationProfiler::CATEGORY_PHYSICS);
+    const auto testRange = [this, &bodies, &tests](const size_t begin, const size_t end) {
+        for(size_t i = begin; i < end; ++i)
+        {
+            CollisionTest& test = tests[i];
+            test._collided = _narrow_phrase->collisionManifold(bodies[test._body_index]._candidate, test._candidate, test._manifold);
+        }
+    };
+
+    if(_narrow_phrase_executor && tests.size() > _narrow_phrase_chunk_size)
+        ParallelUtil::forEachChunk(*_narrow_phrase_executor, tests.size(), _narrow_phrase_chunk_size, testRange);
+    else
+        testRange(0, tests.size());
+}
+
+//  Bodies whose bounds stopped overlapping can't be touching, so their contact ends right away, on both sides, without a narrow phase test.
+//  A body removed meanwhile is only dropped from the other one's contacts.
+void ColliderImpl::Stub::dispatchEndedOverlaps()
+{
+    for(const auto& [a, b] : std::exchange(_pair_tracker->_ended, {}))
+    {
+        const sp<Ref> refA = toRigidbodyRef(a);
+        const sp<Ref> refB = toRigidbodyRef(b);
+        if(refA && refB)
+        {
+            RigidbodyImpl& bodyA = refA->instance<RigidbodyImpl>();
+            RigidbodyImpl& bodyB = refB->instance<RigidbodyImpl>();
+            if(bodyA._dynamic_contacts.erase(b) | bodyB._dynamic_contacts.erase(a))
+            {
+                const Rigidbody shadowA = bodyA.makeShadow();
+                const Rigidbody shadowB = bodyB.makeShadow();
+                shadowA.onEndContact(shadowB);
+                shadowB.onEndContact(shadowA);
+            }
+        }
+        else if(refA)
+            refA->instance<RigidbodyImpl>()._dynamic_contacts.erase(b);
+        else if(refB)
+            refB->instance<RigidbodyImpl>()._dynamic_contacts.erase(a);
+    }
+}
+
 void ColliderImpl::Stub::updateBroadPhraseCandidate(const RefId id, const V3& position, const V3& size) const
 {
     for(const auto& i : _broad_phrases | std::views::keys)
@@ -375,12 +471,26 @@ bool ColliderImpl::Stub::update(uint32_t tick)
         else
             _phrase_remove.insert(id);
 
+    dispatchEndedOverlaps();
+
+    Vector<CollisionBody> bodies = std::move(_collision_bodies);
+    Vector<CollisionTest> tests = std::move(_collision_tests);
+    bodies.clear();
+    tests.clear();
     for(const Ref* i : _dirty_rigid_body_refs)
+        i->instance<RigidbodyImpl>().gatherCollisionTests(*this, _phrase_remove, bodies, tests);
+
+    narrowPhraseTest(bodies, tests);
+
+//  Contacts are dispatched body by body, in the same order the tests were gathered, so scripts observe the serial ordering.
+    for(size_t i = 0, j = 0; i < bodies.size(); ++i)
     {
-        auto& bodyImpl = i->instance<RigidbodyImpl>();
-        const float r = bodyImpl._occupy_radius;
-        bodyImpl.collisionTest(*this, bodyImpl._rigidbody_stub->_position.val(), V3(r * 2), _phrase_remove);
+        RigidbodyImpl::ContactDispatcher dispatcher(*this, *bodies[i]._rigidbody);
+        for(; j < tests.size() && tests[j]._body_index == i; ++j)
+            dispatcher.dispatch(tests[j]);
     }
+    _collision_bodies = std::move(bodies);
+    _collision_tests = std::move(tests);
 
     for(const RefId i : _phrase_remove)
     {
@@ -470,7 +580,8 @@ const sp<NarrowPhrase>& ColliderImpl::Stub::narrowPhrase() const
 }
 
 ColliderImpl::BUILDER::BUILDER(BeanFactory& factory, const document& manifest, const sp<ResourceLoaderContext>& resourceLoaderContext)
-    : _narrow_phrase(factory.ensureBuilder<NarrowPhrase>(manifest, "narrow-phrase")), _render_controller(resourceLoaderContext->renderController())
+    : _narrow_phrase(factory.ensureBuilder<NarrowPhrase>(manifest, "narrow-phrase")), _render_controller(resourceLoaderContext->renderController()),
+      _narrow_phrase_chunk_size(Documents::getAttribute<uint32_t>(manifest, "narrow-phrase-chunk-size", 0))
 {
     for(const document& i : manifest->children("broad-phrase"))
         _broad_phrases.emplace_back(factory.ensureBuilder<BroadPhrase>(i), factory.getBuilder<CollisionFilter>(i, "collision-filter"));
@@ -483,7 +594,7 @@ sp<Collider> ColliderImpl::BUILDER::build(const Scope& args)
     Vector<std::pair<sp<BroadPhrase>, sp<CollisionFilter>>> broadPhrases;
     for(const auto& [i, j] : _broad_phrases)
         broadPhrases.emplace_back(i->build(args), j.build(args));
-    return sp<Collider>::make<ColliderImpl>(std::move(broadPhrases), _narrow_phrase->build(args), _render_controller);
+    return sp<Collider>::make<ColliderImpl>(std::move(broadPhrases), _narrow_phrase->build(args), _render_controller, _narrow_phrase_chunk_size);
 }
 
 }
@@ -17,7 +17,7 @@ namespace ark {
 
 class ColliderImpl final : public Collider {
 public:
-    ColliderImpl(Vector<std::pair<sp<BroadPhrase>, sp<CollisionFilter>>> broadPhrases, sp<NarrowPhrase> narrowPhrase, RenderController& renderController);
+    ColliderImpl(Vector<std::pair<sp<BroadPhrase>, sp<CollisionFilter>>> broadPhrases, sp<NarrowPhrase> narrowPhrase, RenderController& renderController, uint32_t narrowPhraseChunkSize = 0);
 
     sp<RigidbodyController> createBody(Rigidbody::BodyType type, sp<Shape> shape, sp<Vec3> position, sp<Vec4> rotation, sp<CollisionFilter> collisionFilter, sp<Boolean> discarded) override;
     sp<Shape> createShape(const NamedHash& type, Optional<V3> scale, const V3& origin) override;
@@ -35,12 +35,18 @@ public:
         Vector<std::pair<sp<Builder<BroadPhrase>>, SafeBuilder<CollisionFilter>>> _broad_phrases;
         sp<Builder<NarrowPhrase>> _narrow_phrase;
         sp<RenderController> _render_controller;
+        uint32_t _narrow_phrase_chunk_size;
     };
 
     class RigidbodyImpl;
+    class PairTracker;
+
+    struct CollisionBody;
+    struct CollisionTest;
 
     struct Stub final : Updatable {
-        Stub(Vector<std::pair<sp<BroadPhrase>, sp<CollisionFilter>>> broadPhrases, sp<NarrowPhrase> narrowPhrase);
+        Stub(Vector<std::pair<sp<BroadPhrase>, sp<CollisionFilter>>> broadPhrases, sp<NarrowPhrase> narrowPhrase, uint32_t narrowPhraseChunkSize);
+        ~Stub() override;
 
         Vector<RayCastManifold> rayCast(V3 from, V3 to, const sp<CollisionFilter>& collisionFilter) const;
 
@@ -58,11 +64,14 @@ public:
         bool update(uint32_t tick) override;
 
     private:
-        void broadPhraseSearch(BroadPhraseCallback& callback, V3 position, V3 size, const sp<CollisionFilter>& collisionFilter) const;
+        void broadPhraseSearch(BroadPhraseCallback& callback, RefId id, V3 position, V3 size, const sp<CollisionFilter>& collisionFilter) const;
+        void narrowPhraseTest(const Vector<CollisionBody>& bodies, Vector<CollisionTest>& tests) const;
+        void dispatchEndedOverlaps();
 
     private:
         Vector<std::pair<sp<BroadPhrase>, sp<CollisionFilter>>> _broad_phrases;
         sp<NarrowPhrase> _narrow_phrase;
+        sp<PairTracker> _pair_tracker;
 
         HashMap<RefId, sp<Ref>> _rigid_bodies;
         Set<const Ref*> _dirty_rigid_body_refs;
@@ -70,6 +79,12 @@ public:
         Set<RefId> _phrase_discard;
         Set<RefId> _phrase_remove;
 
+        sp<Executor> _narrow_phrase_executor;
+        uint32_t _narrow_phrase_chunk_size;
+
+        Vector<CollisionBody> _collision_bodies;
+        Vector<CollisionTest> _collision_tests;
+
         friend class RigidbodyImpl;
     };
 
@@ -33,13 +33,29 @@ public:
         virtual void remove(RefId id) = 0;
     };
 
+    class PairListener {
+    public:
+        virtual ~PairListener() = default;
+
+        virtual void onBeginOverlap(RefId a, RefId b) = 0;
+        virtual void onEndOverlap(RefId a, RefId b) = 0;
+    };
+
 public:
     virtual ~BroadPhrase() = default;
 
     virtual sp<Coordinator> requestCoordinator() = 0;
 
     virtual void search(BroadPhraseCallback& callback, V3 position, V3 size) = 0;
+//  Reports the candidates overlapping "id" from a persistent pair cache, returns false if there's none and search() should be used instead.
+    virtual bool searchOverlaps(BroadPhraseCallback& /*callback*/, RefId /*id*/) {
+        return false;
+    }
     virtual void rayCast(BroadPhraseCallback& callback, V3 from, V3 to, const sp<CollisionFilter>& collisionFilter = nullptr) = 0;
+
+//  Broad phases with a persistent pair cache report the pairs that begin and stop overlapping to it, the others ignore it.
+    virtual void setPairListener(sp<PairListener> /*pairListener*/) {
+    }
 };
 
 }
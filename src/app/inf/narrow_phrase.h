@@ -40,6 +40,7 @@ public:
 
     virtual Ray toRay(const V2& from, const V2& to) = 0;
 
+//  Called from the thread pool when the Collider has a narrow-phrase-chunk-size, so it must not mutate shared state.
     virtual bool collisionManifold(const BroadPhrase::Candidate& candidateOne, const BroadPhrase::Candidate& candidateOther, CollisionManifold& collisionManifold) = 0;
     virtual Optional<RayCastManifold> rayCastManifold(const Ray& ray, const BroadPhrase::Candidate& candidate) = 0;
 };
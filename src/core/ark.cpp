@@ -375,7 +375,9 @@ const char** Ark::argv() const
 
 sp<Application> Ark::makeApplication() const
 {
-    sp<Application> application = _application_context->resourceLoader()->beanFactory().build<Application>(Global<Constants>()->DOCUMENT_NONE, {});
+//  <application class="..."/> picks an Application other than the platform's default one, e.g. "headless".
+    const document& applicationManifest = _manifest->content()->getChild("application");
+    sp<Application> application = _application_context->resourceLoader()->beanFactory().build<Application>(applicationManifest ? applicationManifest : Global<Constants>()->DOCUMENT_NONE, {});
     CHECK(application, "Failed to create application. It's likely certain plugins are not loaded, such as SDL.");
     return application;
 }
@@ -1,71 +1,168 @@
 #include "core/base/allocator.h"
 
+#include <new>
+
 namespace ark {
 
+namespace {
+
+constexpr size_t CHUNK_ALIGNMENT = 4096;
+
+struct ThreadCache {
+    uint64_t _allocator_id;
+    void* _chunk;
+};
+
+thread_local ThreadCache _thread_cache = {0, nullptr};
+
+std::atomic<uint64_t> _allocator_id_counter = 0;
+
+}
+
 struct Allocator::Chunk {
+    Chunk(uint8_t* memory, const size_t capacity)
+        : _begin(memory), _end(memory + capacity), _allocated_ptr(memory)
+    {
+    }
 
-    Chunk(const size_t chunkSize)
-        : _memory(chunkSize), _allocated_ptr(_memory.data())
+    static Chunk* create(const size_t capacity)
     {
+        uint8_t* memory = static_cast<uint8_t*>(::operator new(capacity, std::align_val_t(CHUNK_ALIGNMENT)));
+        return new Chunk(memory, capacity);
     }
 
-    uint8_t* allocate(const size_t size)
+    static void destroy(Chunk* chunk)
     {
-        if(const uint8_t* const end = &_memory.back() + 1; _allocated_ptr + size > end)
+        ::operator delete(chunk->_begin, std::align_val_t(CHUNK_ALIGNMENT));
+        delete chunk;
+    }
+
+    size_t capacity() const
+    {
+        return _end - _begin;
+    }
+
+    size_t allocated() const
+    {
+        return _allocated_ptr - _begin;
+    }
+
+    uint8_t* allocate(const size_t size, const size_t alignment)
+    {
+        const uintptr_t aligned = (reinterpret_cast<uintptr_t>(_allocated_ptr) + alignment - 1) / alignment * alignment;
+        uint8_t* ptr = reinterpret_cast<uint8_t*>(aligned);
+        if(ptr + size > _end)
             return nullptr;
 
-        uint8_t* ptr = _allocated_ptr;
-        _allocated_ptr += size;
+        _allocated_ptr = ptr + size;
         return ptr;
     }
 
-    Vector<uint8_t> _memory;
+    uint8_t* _begin;
+    uint8_t* _end;
     uint8_t* _allocated_ptr;
 };
 
-Allocator::Allocator()
-    : _default_chunk_size(64 * 1024)
+Allocator::Pool::Pool(const size_t chunkSize, const size_t maxPooledChunks)
+    : _chunk_size((chunkSize + CHUNK_ALIGNMENT - 1) / CHUNK_ALIGNMENT * CHUNK_ALIGNMENT), _max_pooled_chunks(maxPooledChunks), _last_frame_bytes(0), _high_water_mark(0)
 {
 }
 
-Allocator::~Allocator()
+Allocator::Pool::~Pool()
 {
+    for(Chunk* i : _free_chunks)
+        Chunk::destroy(i);
 }
 
-uint8_t* Allocator::sbrk(const size_t size, const size_t alignment)
+size_t Allocator::Pool::chunkSize() const
 {
-    const size_t m = size % alignment;
-    const size_t sizeNeeded = size + (m ? alignment - m : 0);
+    return _chunk_size;
+}
 
-    uint8_t* ptr = _sbrk(sizeNeeded);
-    if(const size_t mod = reinterpret_cast<size_t>(ptr) % alignment)
-        ptr += (alignment - mod);
+size_t Allocator::Pool::lastFrameBytes() const
+{
+    return _last_frame_bytes.load(std::memory_order_relaxed);
+}
 
-    return ptr;
+size_t Allocator::Pool::highWaterMark() const
+{
+    return _high_water_mark.load(std::memory_order_relaxed);
+}
+
+size_t Allocator::Pool::pooledChunks() const
+{
+    const std::lock_guard guard(_mutex);
+    return _free_chunks.size();
 }
 
-uint8_t* Allocator::_sbrk(const size_t size)
+Allocator::Chunk* Allocator::Pool::obtain(const size_t size)
 {
-    if(size > _default_chunk_size)
+    if(size > _chunk_size)
+        return Chunk::create((size + CHUNK_ALIGNMENT - 1) / CHUNK_ALIGNMENT * CHUNK_ALIGNMENT);
+
     {
-        sp<Chunk> chunk = sp<Chunk>::make(size);
-        uint8_t* ptr = chunk->allocate(size);
-        _allocated.push(std::move(chunk));
-        return ptr;
+        const std::lock_guard guard(_mutex);
+        if(!_free_chunks.empty())
+        {
+            Chunk* chunk = _free_chunks.back();
+            _free_chunks.pop_back();
+            return chunk;
+        }
     }
+    return Chunk::create(_chunk_size);
+}
 
-    while(true)
+void Allocator::Pool::recycle(Chunk* chunk)
+{
+    if(chunk->capacity() == _chunk_size)
     {
-        Optional<sp<Chunk>> optLocked = _actived.pop();
-        sp<Chunk> locked = optLocked ? std::move(optLocked.value()) : sp<Chunk>::make(_default_chunk_size);
-        if(uint8_t* ptr = locked->allocate(size))
+        chunk->_allocated_ptr = chunk->_begin;
+        const std::lock_guard guard(_mutex);
+        if(_free_chunks.size() < _max_pooled_chunks)
         {
-            _actived.push(std::move(locked));
-            return ptr;
+            _free_chunks.push_back(chunk);
+            return;
         }
+    }
+    Chunk::destroy(chunk);
+}
 
-        _allocated.push(std::move(locked));
+void Allocator::Pool::onFrameReleased(const size_t allocatedBytes)
+{
+    _last_frame_bytes.store(allocatedBytes, std::memory_order_relaxed);
+    size_t highWaterMark = _high_water_mark.load(std::memory_order_relaxed);
+    while(allocatedBytes > highWaterMark && !_high_water_mark.compare_exchange_weak(highWaterMark, allocatedBytes, std::memory_order_relaxed));
+}
+
+Allocator::Allocator(sp<Pool> pool)
+    : _pool(pool ? std::move(pool) : sp<Pool>::make()), _id(++ _allocator_id_counter)
+{
+}
+
+Allocator::~Allocator()
+{
+    size_t allocatedBytes = 0;
+    for(Chunk* i : _chunks.clear())
+    {
+        allocatedBytes += i->allocated();
+        _pool->recycle(i);
     }
+    _pool->onFrameReleased(allocatedBytes);
+}
+
+uint8_t* Allocator::sbrk(const size_t size, const size_t alignment)
+{
+    ThreadCache& cache = _thread_cache;
+    if(cache._allocator_id == _id)
+        if(uint8_t* ptr = static_cast<Chunk*>(cache._chunk)->allocate(size, alignment))
+            return ptr;
+
+    Chunk* chunk = obtainChunk(size + alignment);
+    uint8_t* ptr = chunk->allocate(size, alignment);
+    ASSERT(ptr);
+    if(chunk->capacity() == _pool->chunkSize())
+        cache = {_id, chunk};
+    return ptr;
 }
 
 ByteArray::View Allocator::sbrkSpan(size_t size, const size_t alignment)
@@ -73,4 +170,11 @@ ByteArray::View Allocator::sbrkSpan(size_t size, const size_t alignment)
     return {sbrk(size, alignment), size};
 }
 
+Allocator::Chunk* Allocator::obtainChunk(const size_t size)
+{
+    Chunk* chunk = _pool->obtain(size);
+    _chunks.push(chunk);
+    return chunk;
+}
+
 }
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <mutex>
+
 #include "core/base/api.h"
 #include "core/concurrent/lf_stack.h"
 #include "core/inf/array.h"
@@ -8,22 +11,62 @@
 namespace ark {
 
 class ARK_API Allocator {
+private:
+    struct Chunk;
+
+public:
+//  Recycles chunks between frames. Shared by every Allocator that draws memory from it, usually one per RenderRequest.
+    class ARK_API Pool {
+    public:
+        Pool(size_t chunkSize = 64 * 1024, size_t maxPooledChunks = 256);
+        ~Pool();
+        DISALLOW_COPY_AND_ASSIGN(Pool);
+
+        size_t chunkSize() const;
+
+//  Bytes handed out by the last released Allocator, and the largest such figure seen so far.
+        size_t lastFrameBytes() const;
+        size_t highWaterMark() const;
+
+        size_t pooledChunks() const;
+
+    private:
+        Chunk* obtain(size_t size);
+        void recycle(Chunk* chunk);
+
+        void onFrameReleased(size_t allocatedBytes);
+
+    private:
+        size_t _chunk_size;
+        size_t _max_pooled_chunks;
+
+        mutable std::mutex _mutex;
+        Vector<Chunk*> _free_chunks;
+
+        std::atomic<size_t> _last_frame_bytes;
+        std::atomic<size_t> _high_water_mark;
+
+        friend class Allocator;
+    };
+
 public:
-    Allocator();
+    Allocator(sp<Pool> pool = nullptr);
     ~Allocator();
+    DISALLOW_COPY_AND_ASSIGN(Allocator);
 
+//  [[ark::threadsafe]]
     uint8_t* sbrk(size_t size, size_t alignment = sizeof(void*));
+//  [[ark::threadsafe]]
     ByteArray::View sbrkSpan(size_t size, size_t alignment = sizeof(void*));
 
 private:
-    uint8_t* _sbrk(size_t size);
+    Chunk* obtainChunk(size_t size);
 
 private:
-    size_t _default_chunk_size;
+    sp<Pool> _pool;
+    uint64_t _id;
 
-    struct Chunk;
-    LFStack<sp<Chunk>> _actived;
-    LFStack<sp<Chunk>> _allocated;
+    LFStack<Chunk*> _chunks;
 };
 
 }
@@ -1,5 +1,7 @@
 #include "core/base/message_loop.h"
 
+#include <algorithm>
+
 #include "core/ark.h"
 
 #include "core/inf/runnable.h"
@@ -40,7 +42,7 @@ MessageLoop::MessageLoop(sp<Variable<uint64_t>> clock)
 }
 
 MessageLoop::MessageLoop(sp<Variable<uint64_t>> clock, sp<Executor> executor)
-    : _clock(std::move(clock)), _executor(std::move(executor))
+    : _clock(std::move(clock)), _executor(std::move(executor)), _wheel_tick(_clock->val() / WHEEL_RESOLUTION), _wheel_size(0)
 {
 }
 
@@ -70,34 +72,96 @@ void MessageLoop::pollOnce()
     for(sp<Task>& task : _scheduled.clear())
         requestNextTask(std::move(task));
 
-    while(!_tasks.empty())
-        if(const Task& front = *_tasks.front(); front._next_fire_tick <= now)
+    _expired.swap(_overdue);
+    for(const uint64_t nowTick = now / WHEEL_RESOLUTION; _wheel_tick <= nowTick; )
+        if(_wheel_size == 0)
+            _wheel_tick = nowTick + 1;
+        else
+            expireWheelTick();
+
+    if(_expired.empty())
+        return;
+
+    std::stable_sort(_expired.begin(), _expired.end(), [](const sp<Task>& a, const sp<Task>& b) {
+        return a->_next_fire_tick < b->_next_fire_tick;
+    });
+
+    for(sp<Task>& i : _expired)
+    {
+        if(i->isCancelled())
+            continue;
+
+        if(i->_next_fire_tick > now)
         {
-            sp<Task> nextTask = _tasks.front();
-            _tasks.pop_front();
-            if(!nextTask->isCancelled())
-            {
-                if(nextTask->_interval)
-                {
-                    nextTask->_next_fire_tick = now + nextTask->_interval;
-                    requestNextTask(nextTask);
-                }
-                _executor->execute(nextTask);
-            }
+            _overdue.push_back(std::move(i));
+            continue;
         }
-        else
-            break;
+
+        if(i->_interval)
+        {
+            i->_next_fire_tick = now + i->_interval;
+            requestNextTask(i);
+        }
+        _executor->execute(i);
+    }
+    _expired.clear();
 }
 
 void MessageLoop::requestNextTask(sp<Task> task)
 {
-    for(auto iter = _tasks.begin(); iter != _tasks.end(); ++iter)
-        if(const sp<Task>& i = *iter; i->_next_fire_tick > task->_next_fire_tick)
+    uint64_t tick = task->_next_fire_tick / WHEEL_RESOLUTION;
+    if(tick < _wheel_tick)
+    {
+        _overdue.push_back(std::move(task));
+        return;
+    }
+
+    uint32_t slotOffset = 0;
+    uint32_t shift = 0;
+    uint32_t bits = WHEEL_ROOT_BITS;
+    for(uint32_t level = 0; level <= WHEEL_LEVEL_COUNT; ++level)
+    {
+        if(const uint64_t delta = tick - _wheel_tick; delta < (1ull << (shift + bits)) || level == WHEEL_LEVEL_COUNT)
         {
-            _tasks.insert(iter, std::move(task));
+            if(delta >= (1ull << (shift + bits)))
+                tick = _wheel_tick + (1ull << (shift + bits)) - 1;
+            _wheel[slotOffset + ((tick >> shift) & ((1u << bits) - 1))].push_back(std::move(task));
+            ++ _wheel_size;
             return;
         }
-    _tasks.push_back(std::move(task));
+        slotOffset += 1u << bits;
+        shift += bits;
+        bits = WHEEL_LEVEL_BITS;
+    }
+}
+
+void MessageLoop::cascade(const uint32_t level)
+{
+    const uint32_t shift = WHEEL_ROOT_BITS + (level - 1) * WHEEL_LEVEL_BITS;
+    const uint32_t index = (_wheel_tick >> shift) & ((1u << WHEEL_LEVEL_BITS) - 1);
+    if(index == 0 && level < WHEEL_LEVEL_COUNT)
+        cascade(level + 1);
+
+    _cascading.swap(_wheel[(1u << WHEEL_ROOT_BITS) + (level - 1) * (1u << WHEEL_LEVEL_BITS) + index]);
+    _wheel_size -= _cascading.size();
+    for(sp<Task>& i : _cascading)
+        if(!i->isCancelled())
+            requestNextTask(std::move(i));
+    _cascading.clear();
+}
+
+void MessageLoop::expireWheelTick()
+{
+    const uint32_t index = _wheel_tick & ((1u << WHEEL_ROOT_BITS) - 1);
+    if(index == 0)
+        cascade(1);
+
+    Vector<sp<Task>>& slot = _wheel[index];
+    _wheel_size -= slot.size();
+    for(sp<Task>& i : slot)
+        _expired.push_back(std::move(i));
+    slot.clear();
+    ++ _wheel_tick;
 }
 
 }
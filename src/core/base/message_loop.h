@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 #include "core/forwarding.h"
 #include "core/base/api.h"
 #include "core/concurrent/lf_stack.h"
@@ -23,13 +25,29 @@ public:
 private:
     class Task;
 
+//  Hierarchical timing wheel: one 256 slot level at WHEEL_RESOLUTION followed by three 64 slot levels, covering ~18 hours.
+//  Tasks beyond that range are parked in the last slot reachable and re-cascaded until they come into range.
+    static constexpr uint64_t WHEEL_RESOLUTION = 1000;
+    static constexpr uint32_t WHEEL_ROOT_BITS = 8;
+    static constexpr uint32_t WHEEL_LEVEL_BITS = 6;
+    static constexpr uint32_t WHEEL_LEVEL_COUNT = 3;
+    static constexpr uint32_t WHEEL_SLOT_COUNT = (1 << WHEEL_ROOT_BITS) + (1 << WHEEL_LEVEL_BITS) * WHEEL_LEVEL_COUNT;
+
     void requestNextTask(sp<Task> task);
+    void cascade(uint32_t level);
+    void expireWheelTick();
 
 private:
     sp<Variable<uint64_t>> _clock;
     sp<Executor> _executor;
 
-    List<sp<Task>> _tasks;
+    uint64_t _wheel_tick;
+    size_t _wheel_size;
+    std::array<Vector<sp<Task>>, WHEEL_SLOT_COUNT> _wheel;
+    Vector<sp<Task>> _overdue;
+    Vector<sp<Task>> _expired;
+    Vector<sp<Task>> _cascading;
+
     LFStack<sp<Task>> _scheduled;
 };
 
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <new>
+
+#include "core/forwarding.h"
+#include "core/base/api.h"
+#include "core/types/optional.h"
+
+namespace ark {
+
+// Bounded multi-producer multi-consumer ring queue with strict FIFO ordering (D. Vyukov's sequence-stamped cells).
+// Elements are constructed in place, so pushing and popping never touches the heap after construction.
+template<typename T> class LFRingQueue {
+public:
+    LFRingQueue(const size_t capacity)
+        : _mask(roundUpPowerOfTwo(capacity) - 1), _cells(std::make_unique<Cell[]>(_mask + 1)), _enqueue_position(0), _dequeue_position(0) {
+        for(size_t i = 0; i <= _mask; ++i)
+            _cells[i]._sequence.store(i, std::memory_order_relaxed);
+    }
+    ~LFRingQueue() {
+        while(pop());
+    }
+
+    size_t capacity() const {
+        return _mask + 1;
+    }
+
+//  [[ark::threadsafe]]
+    size_t size() const {
+        const size_t enqueuePosition = _enqueue_position.load(std::memory_order_relaxed);
+        const size_t dequeuePosition = _dequeue_position.load(std::memory_order_relaxed);
+        return enqueuePosition > dequeuePosition ? enqueuePosition - dequeuePosition : 0;
+    }
+
+//  [[ark::threadsafe]]
+    bool tryPush(T data) {
+        Cell* cell;
+        size_t position = _enqueue_position.load(std::memory_order_relaxed);
+        while(true) {
+            cell = &_cells[position & _mask];
+            const size_t sequence = cell->_sequence.load(std::memory_order_acquire);
+            if(const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position); diff == 0) {
+                if(_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if(diff < 0)
+                return false;
+            else
+                position = _enqueue_position.load(std::memory_order_relaxed);
+        }
+        new(cell->_storage) T(std::move(data));
+        cell->_sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+//  [[ark::threadsafe]]
+    Optional<T> pop() {
+        Cell* cell;
+        size_t position = _dequeue_position.load(std::memory_order_relaxed);
+        while(true) {
+            cell = &_cells[position & _mask];
+            const size_t sequence = cell->_sequence.load(std::memory_order_acquire);
+            if(const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1); diff == 0) {
+                if(_dequeue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if(diff < 0)
+                return {};
+            else
+                position = _dequeue_position.load(std::memory_order_relaxed);
+        }
+        T& slot = *std::launder(reinterpret_cast<T*>(cell->_storage));
+        Optional<T> data(std::move(slot));
+        slot.~T();
+        cell->_sequence.store(position + _mask + 1, std::memory_order_release);
+        return data;
+    }
+
+//  [[ark::threadsafe]]
+//  Claims the run of published cells at the head with a single CAS on the dequeue cursor, then consumes them in FIFO order.
+    template<typename F> size_t drain(F consumer, const size_t maxCount = std::numeric_limits<size_t>::max()) {
+        const size_t limit = std::min(maxCount, _mask + 1);
+        size_t position = _dequeue_position.load(std::memory_order_relaxed);
+        size_t count;
+        while(true) {
+            count = 0;
+            while(count < limit && _cells[(position + count) & _mask]._sequence.load(std::memory_order_acquire) == position + count + 1)
+                ++ count;
+            if(count == 0 || _dequeue_position.compare_exchange_weak(position, position + count, std::memory_order_relaxed))
+                break;
+        }
+
+        for(size_t i = 0; i < count; ++i) {
+            Cell& cell = _cells[(position + i) & _mask];
+            T& slot = *std::launder(reinterpret_cast<T*>(cell._storage));
+            T data(std::move(slot));
+            slot.~T();
+            cell._sequence.store(position + i + _mask + 1, std::memory_order_release);
+            consumer(std::move(data));
+        }
+        return count;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> _sequence;
+        alignas(T) std::byte _storage[sizeof(T)];
+    };
+
+    static size_t roundUpPowerOfTwo(const size_t value) {
+        size_t capacity = 2;
+        while(capacity < value)
+            capacity <<= 1;
+        return capacity;
+    }
+
+private:
+    size_t _mask;
+    std::unique_ptr<Cell[]> _cells;
+
+    alignas(64) std::atomic<size_t> _enqueue_position;
+    alignas(64) std::atomic<size_t> _dequeue_position;
+
+    DISALLOW_COPY_AND_ASSIGN(LFRingQueue);
+};
+
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <type_traits>
+
+#include "core/base/api.h"
+#include "core/types/optional.h"
+
+namespace ark {
+
+// Chase-Lev work-stealing deque, following "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et al. 2013).
+// The owner thread pushes and pops at the bottom, any other thread may steal from the top.
+// Retired buffers are kept alive until destruction so that in-flight thieves never read freed memory.
+template<typename T> class WorkStealingDeque {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque elements must be trivially copyable");
+
+    WorkStealingDeque(const int64_t capacity = 256)
+        : _top(0), _bottom(0), _buffer(new Buffer(capacity, nullptr)) {
+        DCHECK(capacity > 0 && (capacity & (capacity - 1)) == 0, "Capacity must be a power of two");
+    }
+    ~WorkStealingDeque() {
+        Buffer* iter = _buffer.load(std::memory_order_relaxed);
+        while(iter) {
+            Buffer* retired = iter->_retired;
+            delete iter;
+            iter = retired;
+        }
+    }
+
+//  [[ark::threadsafe]]
+    int64_t size() const {
+        const int64_t b = _bottom.load(std::memory_order_relaxed);
+        const int64_t t = _top.load(std::memory_order_relaxed);
+        return b > t ? b - t : 0;
+    }
+
+//  Owner thread only
+    void push(T data) {
+        const int64_t b = _bottom.load(std::memory_order_relaxed);
+        const int64_t t = _top.load(std::memory_order_acquire);
+        Buffer* buffer = _buffer.load(std::memory_order_relaxed);
+        if(b - t > buffer->_mask) {
+            buffer = buffer->grow(b, t);
+            _buffer.store(buffer, std::memory_order_release);
+        }
+        buffer->put(b, data);
+        std::atomic_thread_fence(std::memory_order_release);
+        _bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+//  Owner thread only
+    Optional<T> pop() {
+        const int64_t b = _bottom.load(std::memory_order_relaxed) - 1;
+        Buffer* buffer = _buffer.load(std::memory_order_relaxed);
+        _bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = _top.load(std::memory_order_relaxed);
+        if(t > b) {
+            _bottom.store(b + 1, std::memory_order_relaxed);
+            return {};
+        }
+
+        const T data = buffer->get(b);
+        if(t == b) {
+            const bool won = _top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            _bottom.store(b + 1, std::memory_order_relaxed);
+            if(!won)
+                return {};
+        }
+        return data;
+    }
+
+//  [[ark::threadsafe]]
+    Optional<T> steal() {
+        int64_t t = _top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = _bottom.load(std::memory_order_acquire);
+        if(t >= b)
+            return {};
+
+        const T data = _buffer.load(std::memory_order_acquire)->get(t);
+        if(!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return {};
+        return data;
+    }
+
+private:
+    struct Buffer {
+        Buffer(const int64_t capacity, Buffer* retired)
+            : _mask(capacity - 1), _slots(new std::atomic<T>[capacity]), _retired(retired) {
+        }
+        ~Buffer() {
+            delete[] _slots;
+        }
+
+        T get(const int64_t index) const {
+            return _slots[index & _mask].load(std::memory_order_relaxed);
+        }
+
+        void put(const int64_t index, T data) {
+            _slots[index & _mask].store(data, std::memory_order_relaxed);
+        }
+
+        Buffer* grow(const int64_t bottom, const int64_t top) {
+            Buffer* buffer = new Buffer((_mask + 1) * 2, this);
+            for(int64_t i = top; i < bottom; ++i)
+                buffer->put(i, get(i));
+            return buffer;
+        }
+
+        int64_t _mask;
+        std::atomic<T>* _slots;
+        Buffer* _retired;
+    };
+
+private:
+    alignas(64) std::atomic<int64_t> _top;
+    alignas(64) std::atomic<int64_t> _bottom;
+    alignas(64) std::atomic<Buffer*> _buffer;
+
+    DISALLOW_COPY_AND_ASSIGN(WorkStealingDeque);
+};
+
+}
@@ -28,6 +28,7 @@ template<typename T> class Loader;
 template<typename T> class LoaderBundle;
 template<typename T> class LFStack;
 template<typename T> class LFQueue;
+template<typename T> class LFRingQueue;
 template<typename T> class Range;
 template<typename T> class OptionalVar;
 template<typename T> class SharedPtr;
@@ -74,6 +75,7 @@ class Enum;
 class Executor;
 class ExecutorScheduled;
 class ExecutorThreadPool;
+class ExecutorWorkStealing;
 class Uploader;
 class Future;
 class Debris;
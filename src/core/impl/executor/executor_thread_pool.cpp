@@ -1,27 +1,10 @@
 #include "core/impl/executor/executor_thread_pool.h"
 
 #include "core/base/string.h"
+#include "core/impl/runnable/runnable_fatal_exception.h"
 
 namespace ark {
 
-namespace {
-
-class ThrowException final : public Runnable {
-public:
-    ThrowException(String what)
-        : _what(std::move(what)) {
-    }
-
-    void run() override {
-        FATAL("Unhanlded exception in thread: %s", _what.c_str());
-    }
-
-private:
-    String _what;
-};
-
-}
-
 class ExecutorThreadPool::WorkerThreadStrategy final : public ExecutorWorkerThread::Strategy {
 public:
     WorkerThreadStrategy(const sp<Stub>& stub)
@@ -48,6 +31,10 @@ public:
          -- _stub->_worker_count;
     }
 
+    void onTaskDone() override
+    {
+    }
+
     void onBusy() override
     {
         _idled_cycle = 0;
@@ -63,7 +50,7 @@ public:
     void onException(const std::exception& e) override
     {
         if(_stub->_exception_executor)
-            _stub->_exception_executor->execute(sp<ThrowException>::make(e.what()));
+            _stub->_exception_executor->execute(sp<Runnable>::make<RunnableFatalException>(e.what()));
     }
 
     bool isIdle() const
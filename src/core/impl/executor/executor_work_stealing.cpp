@@ -0,0 +1,187 @@
+#include "core/impl/executor/executor_work_stealing.h"
+
+#include "core/ark.h"
+#include "core/base/string.h"
+#include "core/impl/runnable/runnable_fatal_exception.h"
+
+namespace ark {
+
+class ExecutorWorkStealing::WorkerEntry final : public Runnable {
+public:
+    WorkerEntry(sp<Stub> stub, Worker& worker)
+        : _stub(std::move(stub)), _worker(worker) {
+    }
+
+    void run() override
+    {
+        DPROFILER_TRACE("Worker", ApplicationProfiler::CATEGORY_START_THREAD);
+        Thread::local<Worker*>() = &_worker;
+        _stub->run(_worker);
+        Thread::local<Worker*>() = nullptr;
+    }
+
+private:
+    sp<Stub> _stub;
+    Worker& _worker;
+};
+
+ExecutorWorkStealing::ExecutorWorkStealing(sp<Executor> exceptionExecutor, const uint32_t capacity)
+    : _stub(sp<Stub>::make(std::move(exceptionExecutor), std::max<uint32_t>(2, capacity ? capacity : std::thread::hardware_concurrency())))
+{
+    for(const std::unique_ptr<Worker>& i : _stub->_workers)
+    {
+        i->_thread.setEntry(sp<Runnable>::make<WorkerEntry>(_stub, *i));
+        i->_thread.start();
+    }
+}
+
+ExecutorWorkStealing::~ExecutorWorkStealing()
+{
+    releaseAll(false);
+}
+
+void ExecutorWorkStealing::execute(const sp<Runnable>& task)
+{
+    Task boxed = new sp<Runnable>(task);
+    if(Worker* worker = Thread::local<Worker*>(); worker && &worker->_owner == _stub.get())
+    {
+        worker->_tasks.push(boxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(_stub->_parking_count.load(std::memory_order_relaxed) > 0)
+            _stub->wakeUp();
+    }
+    else
+        _stub->submit(boxed);
+}
+
+void ExecutorWorkStealing::releaseAll(const bool wait) const
+{
+    if(!_stub->_terminated.exchange(true))
+    {
+        _stub->_parking_epoch.fetch_add(1, std::memory_order_release);
+        _stub->_parking_epoch.notify_all();
+    }
+
+    if(wait)
+        for(const std::unique_ptr<Worker>& i : _stub->_workers)
+            if(Thread::local<Worker*>() != i.get())
+                i->_thread.tryJoin();
+}
+
+ExecutorWorkStealing::Worker::Worker(const Stub& owner, const uint32_t index)
+    : _owner(owner), _index(index), _seed(index * 2654435761u + 1)
+{
+}
+
+ExecutorWorkStealing::Stub::Stub(sp<Executor> exceptionExecutor, const uint32_t capacity)
+    : _exception_executor(std::move(exceptionExecutor)), _global_size(0), _parking_epoch(0), _parking_count(0), _terminated(false)
+{
+    for(uint32_t i = 0; i < capacity; ++i)
+        _workers.push_back(std::make_unique<Worker>(*this, i));
+}
+
+ExecutorWorkStealing::Stub::~Stub()
+{
+    for(const std::unique_ptr<Worker>& i : _workers)
+        while(const Optional<Task> opt = i->_tasks.pop())
+            delete opt.value();
+    for(const Task i : _global_tasks)
+        delete i;
+}
+
+void ExecutorWorkStealing::Stub::submit(Task task)
+{
+    {
+        const std::lock_guard guard(_global_mutex);
+        _global_tasks.push_back(task);
+        _global_size.store(static_cast<uint32_t>(_global_tasks.size()), std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(_parking_count.load(std::memory_order_relaxed) > 0)
+        wakeUp();
+}
+
+void ExecutorWorkStealing::Stub::wakeUp()
+{
+    _parking_epoch.fetch_add(1, std::memory_order_release);
+    _parking_epoch.notify_one();
+}
+
+void ExecutorWorkStealing::Stub::runTask(Task task) const
+{
+    const std::unique_ptr<sp<Runnable>> runnable(task);
+    try {
+        (*runnable)->run();
+    }
+    catch(const std::exception& e) {
+        if(_exception_executor)
+            _exception_executor->execute(sp<Runnable>::make<RunnableFatalException>(e.what()));
+    }
+}
+
+ExecutorWorkStealing::Task ExecutorWorkStealing::Stub::findTask(Worker& worker)
+{
+    if(const Optional<Task> opt = worker._tasks.pop())
+        return opt.value();
+    if(const Task task = popGlobal())
+        return task;
+    return steal(worker);
+}
+
+ExecutorWorkStealing::Task ExecutorWorkStealing::Stub::popGlobal()
+{
+    if(_global_size.load(std::memory_order_relaxed) == 0)
+        return nullptr;
+
+    const std::lock_guard guard(_global_mutex);
+    if(_global_tasks.empty())
+        return nullptr;
+
+    const Task task = _global_tasks.front();
+    _global_tasks.pop_front();
+    _global_size.store(static_cast<uint32_t>(_global_tasks.size()), std::memory_order_relaxed);
+    return task;
+}
+
+ExecutorWorkStealing::Task ExecutorWorkStealing::Stub::steal(Worker& thief)
+{
+    const uint32_t workerCount = static_cast<uint32_t>(_workers.size());
+    thief._seed ^= thief._seed << 13;
+    thief._seed ^= thief._seed >> 17;
+    thief._seed ^= thief._seed << 5;
+
+    const uint32_t start = thief._seed % workerCount;
+    for(uint32_t i = 0; i < workerCount; ++i)
+        if(const uint32_t victim = (start + i) % workerCount; victim != thief._index)
+            if(const Optional<Task> opt = _workers[victim]->_tasks.steal())
+                return opt.value();
+    return nullptr;
+}
+
+void ExecutorWorkStealing::Stub::run(Worker& worker)
+{
+    while(!_terminated.load(std::memory_order_acquire))
+    {
+        if(const Task task = findTask(worker))
+        {
+            runTask(task);
+            continue;
+        }
+
+        const uint32_t epoch = _parking_epoch.load(std::memory_order_acquire);
+        _parking_count.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(const Task task = findTask(worker))
+        {
+            _parking_count.fetch_sub(1, std::memory_order_relaxed);
+            runTask(task);
+            continue;
+        }
+
+        if(!_terminated.load(std::memory_order_acquire))
+            _parking_epoch.wait(epoch, std::memory_order_acquire);
+        _parking_count.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+}
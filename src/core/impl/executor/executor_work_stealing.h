@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+#include "core/base/thread.h"
+#include "core/concurrent/work_stealing_deque.h"
+#include "core/inf/executor.h"
+#include "core/inf/runnable.h"
+#include "core/types/shared_ptr.h"
+
+namespace ark {
+
+class ExecutorWorkStealing final : public Executor {
+public:
+    ExecutorWorkStealing(sp<Executor> exceptionExecutor = nullptr, uint32_t capacity = 0);
+    ~ExecutorWorkStealing() override;
+
+//  [[ark::threadsafe]]
+    void execute(const sp<Runnable>& task) override;
+
+    void releaseAll(bool wait) const;
+
+private:
+    struct Stub;
+    class WorkerEntry;
+
+    typedef sp<Runnable>* Task;
+
+    struct Worker {
+        Worker(const Stub& owner, uint32_t index);
+
+        const Stub& _owner;
+        uint32_t _index;
+        uint32_t _seed;
+
+        WorkStealingDeque<Task> _tasks;
+        Thread _thread;
+    };
+
+    struct Stub {
+        Stub(sp<Executor> exceptionExecutor, uint32_t capacity);
+        ~Stub();
+
+        void submit(Task task);
+        void wakeUp();
+        void runTask(Task task) const;
+
+        Task findTask(Worker& worker);
+        Task popGlobal();
+        Task steal(Worker& thief);
+
+        void run(Worker& worker);
+
+        sp<Executor> _exception_executor;
+        Vector<std::unique_ptr<Worker>> _workers;
+
+        std::mutex _global_mutex;
+        std::deque<Task> _global_tasks;
+        std::atomic<uint32_t> _global_size;
+
+        std::atomic<uint32_t> _parking_epoch;
+        std::atomic<uint32_t> _parking_count;
+        std::atomic<bool> _terminated;
+    };
+
+private:
+    sp<Stub> _stub;
+};
+
+}
@@ -62,6 +62,7 @@ void ExecutorWorkerThread::Worker::run()
                 catch(const std::exception& e) {
                     strategy->onException(e);
                 }
+                strategy->onTaskDone();
                 optTask = _pending_tasks.pop();
             } while(optTask);
 
@@ -18,6 +18,7 @@ public:
         virtual void onStart() = 0;
         virtual void onExit() = 0;
 
+        virtual void onTaskDone() = 0;
         virtual void onBusy() = 0;
         virtual void onIdle(Thread& thread) = 0;
 
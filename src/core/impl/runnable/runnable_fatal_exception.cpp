@@ -0,0 +1,17 @@
+#include "core/impl/runnable/runnable_fatal_exception.h"
+
+#include "core/base/api.h"
+
+namespace ark {
+
+RunnableFatalException::RunnableFatalException(String what)
+    : _what(std::move(what))
+{
+}
+
+void RunnableFatalException::run()
+{
+    FATAL("Unhandled exception in thread: %s", _what.c_str());
+}
+
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "core/base/string.h"
+#include "core/inf/runnable.h"
+
+namespace ark {
+
+//  Reports an exception caught on a worker thread as fatal on the thread that runs it, usually the core thread.
+class RunnableFatalException final : public Runnable {
+public:
+    RunnableFatalException(String what);
+
+    void run() override;
+
+private:
+    String _what;
+};
+
+}
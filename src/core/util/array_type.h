@@ -71,6 +71,13 @@ public:
         return reinterpret_cast<size_t>(self->buf());
     }
 
+//  The array whose storage gets exported through the buffer protocol. Wrappers are unwrapped so a later reset() can't free memory under a live view.
+    static sp<Array<T>> buffer(const sp<Array<T>>& self) {
+        if(const sp<ArrayWrapper> wrapper = self.template asInstance<ArrayWrapper>())
+            return buffer(wrapper->wrapped());
+        return self;
+    }
+
     static size_t len(const sp<Array<T>>& self) {
         return self->length();
     }
@@ -22,6 +22,9 @@ public:
 //  [[script::bindings::property]]
     static size_t nativePtr(const sp<ByteArray>& self);
 
+//  [[script::bindings::buffer]]
+    static sp<ByteArray> buffer(const sp<ByteArray>& self);
+
 //  [[script::bindings::seq(len)]]
     static size_t len(const sp<ByteArray>& self);
 //  [[script::bindings::seq(get)]]
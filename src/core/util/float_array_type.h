@@ -23,6 +23,9 @@ public:
 //  [[script::bindings::property]]
     static size_t nativePtr(const sp<FloatArray>& self);
 
+//  [[script::bindings::buffer]]
+    static sp<FloatArray> buffer(const sp<FloatArray>& self);
+
 //  [[script::bindings::seq(len)]]
     static size_t len(const sp<FloatArray>& self);
 //  [[script::bindings::seq(get)]]
@@ -24,6 +24,9 @@ public:
 //  [[script::bindings::property]]
     static size_t nativePtr(const sp<IntArray>& self);
 
+//  [[script::bindings::buffer]]
+    static sp<IntArray> buffer(const sp<IntArray>& self);
+
 //  [[script::bindings::seq(len)]]
     static size_t len(const sp<IntArray>& self);
 //  [[script::bindings::seq(get)]]
@@ -0,0 +1,100 @@
+#include "core/util/parallel_util.h"
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "core/inf/executor.h"
+#include "core/inf/runnable.h"
+#include "core/types/shared_ptr.h"
+
+namespace ark {
+
+namespace {
+
+struct ChunkState {
+    ChunkState(const size_t count, const size_t chunkSize, const std::function<void(size_t, size_t)>& func)
+        : _count(count), _chunk_size(chunkSize), _chunk_count(ParallelUtil::chunkCount(count, chunkSize)), _func(func), _next_chunk(0), _finished_chunks(0) {
+    }
+
+//  Claims chunks until none are left. A runner that starts after the last chunk was claimed returns without touching "_func",
+//  which keeps the caller-owned function safe to reference even though this state may outlive forEachChunk().
+    void runChunks() {
+        for(size_t chunk = _next_chunk.fetch_add(1, std::memory_order_relaxed); chunk < _chunk_count; chunk = _next_chunk.fetch_add(1, std::memory_order_relaxed)) {
+            const size_t begin = chunk * _chunk_size;
+            try {
+                _func(begin, std::min(begin + _chunk_size, _count));
+            }
+            catch(...) {
+                const std::lock_guard guard(_exception_mutex);
+                if(!_exception)
+                    _exception = std::current_exception();
+            }
+            if(_finished_chunks.fetch_add(1, std::memory_order_acq_rel) + 1 == _chunk_count)
+                _finished_chunks.notify_all();
+        }
+    }
+
+    void waitForAll() {
+        for(size_t finished = _finished_chunks.load(std::memory_order_acquire); finished < _chunk_count; finished = _finished_chunks.load(std::memory_order_acquire))
+            _finished_chunks.wait(finished, std::memory_order_acquire);
+    }
+
+    size_t _count;
+    size_t _chunk_size;
+    size_t _chunk_count;
+    const std::function<void(size_t, size_t)>& _func;
+
+    std::atomic<size_t> _next_chunk;
+    std::atomic<size_t> _finished_chunks;
+
+    std::mutex _exception_mutex;
+    std::exception_ptr _exception;
+};
+
+class ChunkRunner final : public Runnable {
+public:
+    ChunkRunner(sp<ChunkState> state)
+        : _state(std::move(state)) {
+    }
+
+    void run() override {
+        _state->runChunks();
+    }
+
+private:
+    sp<ChunkState> _state;
+};
+
+}
+
+void ParallelUtil::forEachChunk(Executor& executor, const size_t count, const size_t chunkSize, const std::function<void(size_t, size_t)>& func)
+{
+    DCHECK(chunkSize > 0, "Chunk size must be positive");
+    const size_t chunks = chunkCount(count, chunkSize);
+    if(chunks < 2)
+    {
+        if(count)
+            func(0, count);
+        return;
+    }
+
+    const sp<ChunkState> state = sp<ChunkState>::make(count, chunkSize, func);
+    const size_t runners = std::min<size_t>(chunks - 1, std::max(1u, std::thread::hardware_concurrency()));
+    for(size_t i = 0; i < runners; ++i)
+        executor.execute(sp<Runnable>::make<ChunkRunner>(state));
+
+    state->runChunks();
+    state->waitForAll();
+
+    if(state->_exception)
+        std::rethrow_exception(state->_exception);
+}
+
+size_t ParallelUtil::chunkCount(const size_t count, const size_t chunkSize)
+{
+    return (count + chunkSize - 1) / chunkSize;
+}
+
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <functional>
+
+#include "core/forwarding.h"
+#include "core/base/api.h"
+
+namespace ark {
+
+class ARK_API ParallelUtil {
+public:
+//  Splits [0, count) into chunks of "chunkSize" and runs "func(begin, end)" once per chunk, across "executor" and the calling thread.
+//  Returns when every chunk has finished. The first exception thrown by a chunk is rethrown on the calling thread.
+//  Chunk boundaries only depend on "count" and "chunkSize", so writes keyed by element index land in the same place on every run.
+    static void forEachChunk(Executor& executor, size_t count, size_t chunkSize, const std::function<void(size_t, size_t)>& func);
+
+//  Number of chunks forEachChunk splits "count" elements into.
+    static size_t chunkCount(size_t count, size_t chunkSize);
+};
+
+}
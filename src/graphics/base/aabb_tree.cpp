@@ -0,0 +1,305 @@
+#include "graphics/base/aabb_tree.h"
+
+#include <algorithm>
+
+namespace ark {
+
+namespace {
+
+V3 unionMin(const V3& a, const V3& b)
+{
+    return {std::min(a.x(), b.x()), std::min(a.y(), b.y()), std::min(a.z(), b.z())};
+}
+
+V3 unionMax(const V3& a, const V3& b)
+{
+    return {std::max(a.x(), b.x()), std::max(a.y(), b.y()), std::max(a.z(), b.z())};
+}
+
+float surfaceArea(const V3& aabbMin, const V3& aabbMax)
+{
+    const V3 extent = aabbMax - aabbMin;
+    return extent.x() * extent.y() + extent.y() * extent.z() + extent.z() * extent.x();
+}
+
+bool contains(const V3& outerMin, const V3& outerMax, const V3& innerMin, const V3& innerMax)
+{
+    return outerMin.x() <= innerMin.x() && outerMin.y() <= innerMin.y() && outerMin.z() <= innerMin.z()
+        && outerMax.x() >= innerMax.x() && outerMax.y() >= innerMax.y() && outerMax.z() >= innerMax.z();
+}
+
+}
+
+AABBTree::AABBTree(const float fatRatio)
+    : _fat_ratio(fatRatio), _root(NULL_NODE), _free_list(NULL_NODE), _leaf_count(0)
+{
+}
+
+int32_t AABBTree::insert(const V3& aabbMin, const V3& aabbMax, void* userData)
+{
+    const int32_t proxyId = allocateNode();
+    const V3 extension = (aabbMax - aabbMin) * _fat_ratio;
+    Node& node = _nodes[proxyId];
+    node._aabb_min = aabbMin - extension;
+    node._aabb_max = aabbMax + extension;
+    node._user_data = userData;
+    node._height = 0;
+    insertLeaf(proxyId);
+    ++ _leaf_count;
+    return proxyId;
+}
+
+bool AABBTree::update(const int32_t proxyId, const V3& aabbMin, const V3& aabbMax)
+{
+    DASSERT(proxyId >= 0 && proxyId < static_cast<int32_t>(_nodes.size()) && _nodes[proxyId].isLeaf());
+    if(const Node& node = _nodes[proxyId]; contains(node._aabb_min, node._aabb_max, aabbMin, aabbMax))
+        return false;
+
+    removeLeaf(proxyId);
+    const V3 extension = (aabbMax - aabbMin) * _fat_ratio;
+    Node& node = _nodes[proxyId];
+    node._aabb_min = aabbMin - extension;
+    node._aabb_max = aabbMax + extension;
+    insertLeaf(proxyId);
+    return true;
+}
+
+void AABBTree::remove(const int32_t proxyId)
+{
+    DASSERT(proxyId >= 0 && proxyId < static_cast<int32_t>(_nodes.size()) && _nodes[proxyId].isLeaf());
+    removeLeaf(proxyId);
+    freeNode(proxyId);
+    -- _leaf_count;
+}
+
+void AABBTree::clear()
+{
+    _nodes.clear();
+    _root = NULL_NODE;
+    _free_list = NULL_NODE;
+    _leaf_count = 0;
+}
+
+size_t AABBTree::size() const
+{
+    return _leaf_count;
+}
+
+int32_t AABBTree::height() const
+{
+    return _root == NULL_NODE ? 0 : _nodes[_root]._height;
+}
+
+int32_t AABBTree::allocateNode()
+{
+    int32_t nodeId = _free_list;
+    if(nodeId == NULL_NODE)
+    {
+        nodeId = static_cast<int32_t>(_nodes.size());
+        _nodes.emplace_back();
+    }
+    else
+        _free_list = _nodes[nodeId]._parent;
+
+    Node& node = _nodes[nodeId];
+    node._user_data = nullptr;
+    node._parent = NULL_NODE;
+    node._child1 = NULL_NODE;
+    node._child2 = NULL_NODE;
+    node._height = 0;
+    return nodeId;
+}
+
+void AABBTree::freeNode(const int32_t nodeId)
+{
+    Node& node = _nodes[nodeId];
+    node._parent = _free_list;
+    node._height = -1;
+    _free_list = nodeId;
+}
+
+void AABBTree::insertLeaf(const int32_t leaf)
+{
+    if(_root == NULL_NODE)
+    {
+        _root = leaf;
+        _nodes[leaf]._parent = NULL_NODE;
+        return;
+    }
+
+    const V3 leafMin = _nodes[leaf]._aabb_min;
+    const V3 leafMax = _nodes[leaf]._aabb_max;
+
+    int32_t sibling = _root;
+    while(!_nodes[sibling].isLeaf())
+    {
+        const Node& node = _nodes[sibling];
+        const float area = surfaceArea(node._aabb_min, node._aabb_max);
+        const float combinedArea = surfaceArea(unionMin(node._aabb_min, leafMin), unionMax(node._aabb_max, leafMax));
+        const float cost = 2.0f * combinedArea;
+        const float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float childCosts[2];
+        for(int32_t i = 0; i < 2; ++i)
+        {
+            const Node& child = _nodes[i == 0 ? node._child1 : node._child2];
+            const float childArea = surfaceArea(unionMin(child._aabb_min, leafMin), unionMax(child._aabb_max, leafMax));
+            childCosts[i] = (child.isLeaf() ? childArea : childArea - surfaceArea(child._aabb_min, child._aabb_max)) + inheritanceCost;
+        }
+
+        if(cost < childCosts[0] && cost < childCosts[1])
+            break;
+        sibling = childCosts[0] < childCosts[1] ? node._child1 : node._child2;
+    }
+
+    const int32_t oldParent = _nodes[sibling]._parent;
+    const int32_t newParent = allocateNode();
+    Node& parent = _nodes[newParent];
+    parent._parent = oldParent;
+    parent._aabb_min = unionMin(_nodes[sibling]._aabb_min, leafMin);
+    parent._aabb_max = unionMax(_nodes[sibling]._aabb_max, leafMax);
+    parent._height = _nodes[sibling]._height + 1;
+    parent._child1 = sibling;
+    parent._child2 = leaf;
+
+    if(oldParent != NULL_NODE)
+        replaceChild(oldParent, sibling, newParent);
+    else
+        _root = newParent;
+    _nodes[sibling]._parent = newParent;
+    _nodes[leaf]._parent = newParent;
+
+    refit(newParent);
+}
+
+void AABBTree::removeLeaf(const int32_t leaf)
+{
+    if(leaf == _root)
+    {
+        _root = NULL_NODE;
+        return;
+    }
+
+    const int32_t parent = _nodes[leaf]._parent;
+    const int32_t grandParent = _nodes[parent]._parent;
+    const int32_t sibling = _nodes[parent]._child1 == leaf ? _nodes[parent]._child2 : _nodes[parent]._child1;
+
+    if(grandParent != NULL_NODE)
+    {
+        replaceChild(grandParent, parent, sibling);
+        _nodes[sibling]._parent = grandParent;
+        freeNode(parent);
+        refit(grandParent);
+    }
+    else
+    {
+        _root = sibling;
+        _nodes[sibling]._parent = NULL_NODE;
+        freeNode(parent);
+    }
+}
+
+void AABBTree::refit(int32_t nodeId)
+{
+    while(nodeId != NULL_NODE)
+    {
+        nodeId = balance(nodeId);
+        Node& node = _nodes[nodeId];
+        const Node& child1 = _nodes[node._child1];
+        const Node& child2 = _nodes[node._child2];
+        node._height = 1 + std::max(child1._height, child2._height);
+        node._aabb_min = unionMin(child1._aabb_min, child2._aabb_min);
+        node._aabb_max = unionMax(child1._aabb_max, child2._aabb_max);
+        nodeId = node._parent;
+    }
+}
+
+int32_t AABBTree::balance(const int32_t nodeId)
+{
+    Node& a = _nodes[nodeId];
+    if(a.isLeaf() || a._height < 2)
+        return nodeId;
+
+    const int32_t ib = a._child1;
+    const int32_t ic = a._child2;
+    Node& b = _nodes[ib];
+    Node& c = _nodes[ic];
+    const int32_t balance = c._height - b._height;
+
+    if(balance > 1)
+    {
+        const int32_t iF = c._child1;
+        const int32_t iG = c._child2;
+        Node& f = _nodes[iF];
+        Node& g = _nodes[iG];
+
+        c._child1 = nodeId;
+        c._parent = a._parent;
+        a._parent = ic;
+        if(c._parent != NULL_NODE)
+            replaceChild(c._parent, nodeId, ic);
+        else
+            _root = ic;
+
+        const bool rotateF = f._height <= g._height;
+        const int32_t iMoved = rotateF ? iF : iG;
+        const int32_t iKept = rotateF ? iG : iF;
+        Node& moved = _nodes[iMoved];
+        const Node& kept = _nodes[iKept];
+        c._child2 = iKept;
+        a._child2 = iMoved;
+        moved._parent = nodeId;
+        a._aabb_min = unionMin(b._aabb_min, moved._aabb_min);
+        a._aabb_max = unionMax(b._aabb_max, moved._aabb_max);
+        c._aabb_min = unionMin(a._aabb_min, kept._aabb_min);
+        c._aabb_max = unionMax(a._aabb_max, kept._aabb_max);
+        a._height = 1 + std::max(b._height, moved._height);
+        c._height = 1 + std::max(a._height, kept._height);
+        return ic;
+    }
+
+    if(balance < -1)
+    {
+        const int32_t iD = b._child1;
+        const int32_t iE = b._child2;
+        Node& d = _nodes[iD];
+        Node& e = _nodes[iE];
+
+        b._child1 = nodeId;
+        b._parent = a._parent;
+        a._parent = ib;
+        if(b._parent != NULL_NODE)
+            replaceChild(b._parent, nodeId, ib);
+        else
+            _root = ib;
+
+        const bool rotateD = d._height <= e._height;
+        const int32_t iMoved = rotateD ? iD : iE;
+        const int32_t iKept = rotateD ? iE : iD;
+        Node& moved = _nodes[iMoved];
+        const Node& kept = _nodes[iKept];
+        b._child2 = iKept;
+        a._child1 = iMoved;
+        moved._parent = nodeId;
+        a._aabb_min = unionMin(c._aabb_min, moved._aabb_min);
+        a._aabb_max = unionMax(c._aabb_max, moved._aabb_max);
+        b._aabb_min = unionMin(a._aabb_min, kept._aabb_min);
+        b._aabb_max = unionMax(a._aabb_max, kept._aabb_max);
+        a._height = 1 + std::max(c._height, moved._height);
+        b._height = 1 + std::max(a._height, kept._height);
+        return ib;
+    }
+
+    return nodeId;
+}
+
+void AABBTree::replaceChild(const int32_t parent, const int32_t oldChild, const int32_t newChild)
+{
+    Node& node = _nodes[parent];
+    if(node._child1 == oldChild)
+        node._child1 = newChild;
+    else
+        node._child2 = newChild;
+}
+
+}
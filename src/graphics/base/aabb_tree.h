@@ -0,0 +1,105 @@
+#pragma once
+
+#include "core/base/api.h"
+#include "core/forwarding.h"
+
+#include "graphics/forwarding.h"
+#include "graphics/base/v3.h"
+
+namespace ark {
+
+//  Dynamic AABB tree after Box2D's b2DynamicTree: leaves are inserted by a surface area heuristic and the tree is kept balanced by rotations.
+//  Leaves store boxes fattened by a fraction of their extent, so objects which stay within them don't touch the tree when they move.
+class ARK_API AABBTree {
+public:
+    enum Containment {
+        CONTAINMENT_OUTSIDE,
+        CONTAINMENT_INTERSECTS,
+        CONTAINMENT_INSIDE
+    };
+
+    AABBTree(float fatRatio = 0.1f);
+
+    int32_t insert(const V3& aabbMin, const V3& aabbMax, void* userData);
+//  Returns true if the proxy left its fattened box and got re-inserted.
+    bool update(int32_t proxyId, const V3& aabbMin, const V3& aabbMax);
+    void remove(int32_t proxyId);
+    void clear();
+
+    size_t size() const;
+    int32_t height() const;
+
+//  Calls "classify(aabbMin, aabbMax)" on nodes top-down and "visit(userData, inside)" on every leaf that isn't classified CONTAINMENT_OUTSIDE.
+//  Subtrees classified CONTAINMENT_INSIDE are visited without further tests, with "inside" set to true.
+    template<typename C, typename V> void query(C&& classify, V&& visit) const {
+        if(_root == NULL_NODE)
+            return;
+
+        _query_stack.clear();
+        _query_stack.push_back(_root);
+        while(!_query_stack.empty()) {
+            const int32_t top = _query_stack.back();
+            _query_stack.pop_back();
+            const bool inside = top < 0;
+            const Node& node = _nodes[inside ? ~top : top];
+            if(inside) {
+                if(node.isLeaf())
+                    visit(node._user_data, true);
+                else {
+                    _query_stack.push_back(~node._child1);
+                    _query_stack.push_back(~node._child2);
+                }
+                continue;
+            }
+
+            if(const Containment containment = classify(node._aabb_min, node._aabb_max); containment == CONTAINMENT_INSIDE)
+                _query_stack.push_back(~top);
+            else if(containment == CONTAINMENT_INTERSECTS) {
+                if(node.isLeaf())
+                    visit(node._user_data, false);
+                else {
+                    _query_stack.push_back(node._child1);
+                    _query_stack.push_back(node._child2);
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr int32_t NULL_NODE = -1;
+
+    struct Node {
+        bool isLeaf() const {
+            return _child1 == NULL_NODE;
+        }
+
+        V3 _aabb_min;
+        V3 _aabb_max;
+        void* _user_data;
+        int32_t _parent;
+        int32_t _child1;
+        int32_t _child2;
+        int32_t _height;
+    };
+
+    int32_t allocateNode();
+    void freeNode(int32_t nodeId);
+
+    void insertLeaf(int32_t leaf);
+    void removeLeaf(int32_t leaf);
+    void refit(int32_t nodeId);
+    int32_t balance(int32_t nodeId);
+    void replaceChild(int32_t parent, int32_t oldChild, int32_t newChild);
+
+private:
+    float _fat_ratio;
+
+    int32_t _root;
+    int32_t _free_list;
+    size_t _leaf_count;
+    Vector<Node> _nodes;
+
+    mutable Vector<int32_t> _query_stack;
+};
+
+}
@@ -16,7 +16,7 @@ namespace ark {
 
 LayerContext::LayerContext(sp<Shader> shader, sp<ModelLoader> modelLoader, sp<Vec3> position, sp<Boolean> visible, sp<Boolean> discarded, sp<Varyings> varyings, sp<Updatable> updatable)
     : _shader(std::move(shader)), _model_loader(std::move(modelLoader)), _position(std::move(position)), _visible(std::move(visible), true), _discarded(std::move(discarded), false),
-      _varyings(std::move(varyings)), _updatable(std::move(updatable)), _tick(std::numeric_limits<uint32_t>::max()), _layer_dirty(false), _instances_dirty(false)
+      _varyings(std::move(varyings)), _updatable(std::move(updatable)), _element_order(0), _tick(std::numeric_limits<uint32_t>::max()), _layer_dirty(false), _instances_dirty(false), _culling(false)
 {
 }
 
@@ -90,7 +90,7 @@ bool LayerContext::processNewCreated()
 
     for(sp<Renderable>& i : _newly_created_renderables)
     {
-        addElementState(i.get());
+        addElementState(*i);
         _renderables.emplace_back(std::move(i), Renderable::State(Renderable::RENDERABLE_STATE_NEW));
     }
     _newly_created_renderables.clear();
@@ -109,6 +109,7 @@ void LayerContext::updateFrameState(const RenderRequest& renderRequest)
     _layer_dirty = UpdatableUtil::update(renderRequest.tick(), _updatable, _position, _visible, _discarded, _varyings, _timestamp);
     _instances_dirty = processNewCreated();
     _renderable_states.clear();
+    _dirty_element_states.clear();
     _discarded_element_states.clear();
 
     const bool layerVisible = _visible.val();
@@ -124,6 +125,10 @@ void LayerContext::updateFrameState(const RenderRequest& renderRequest)
             _instances_dirty = true;
             if(const auto fiter = _element_states.find(&renderable); fiter != _element_states.end())
             {
+                if(fiter->second._aabb_proxy >= 0)
+                    _aabb_tree.remove(fiter->second._aabb_proxy);
+                if(fiter->second._unculled_index >= 0)
+                    removeUnculled(fiter->second);
                 _discarded_element_states.push_back(std::move(fiter->second));
                 _element_states.erase(fiter);
             }
@@ -143,7 +148,11 @@ void LayerContext::updateFrameState(const RenderRequest& renderRequest)
 
             const auto fiter = _element_states.find(&renderable);
             DASSERT(fiter != _element_states.end());
-            _renderable_states.emplace_back(&renderable, &fiter->second, state);
+            ElementState& elementState = fiter->second;
+            elementState._state = state;
+            if(state.contains(Renderable::RENDERABLE_STATE_DIRTY))
+                _dirty_element_states.push_back(&elementState);
+            _renderable_states.emplace_back(&renderable, &elementState, state);
             ++iter;
         }
     }
@@ -156,10 +165,37 @@ LayerContextSnapshot LayerContext::snapshot(const RenderRequest& renderRequest,
     return {_position.val(), _layer_dirty, _visible.val(), _discarded.val(), varyings->snapshot(pipelineLayout, renderRequest.allocator())};
 }
 
-LayerContext::ElementState& LayerContext::addElementState(void* key)
+LayerContext::ElementState& LayerContext::addElementState(Renderable& renderable)
 {
-    DASSERT(!_element_states.contains(key));
-    return _element_states.insert(std::make_pair(key, ElementState{})).first->second;
+    DASSERT(!_element_states.contains(&renderable));
+    ElementState& elementState = _element_states.insert(std::make_pair(&renderable, ElementState{})).first->second;
+    elementState._renderable = &renderable;
+    elementState._order = _element_order++;
+    return elementState;
+}
+
+void LayerContext::addUnculled(ElementState& elementState)
+{
+    DASSERT(elementState._unculled_index < 0);
+    elementState._unculled_index = static_cast<int32_t>(_unculled_element_states.size());
+    _unculled_element_states.push_back(&elementState);
+}
+
+void LayerContext::removeUnculled(ElementState& elementState)
+{
+    DASSERT(elementState._unculled_index >= 0 && _unculled_element_states.at(elementState._unculled_index) == &elementState);
+    ElementState* last = _unculled_element_states.back();
+    last->_unculled_index = elementState._unculled_index;
+    _unculled_element_states[elementState._unculled_index] = last;
+    _unculled_element_states.pop_back();
+    elementState._unculled_index = -1;
+}
+
+void LayerContext::clearUnculled()
+{
+    for(ElementState* i : _unculled_element_states)
+        i->_unculled_index = -1;
+    _unculled_element_states.clear();
 }
 
 }
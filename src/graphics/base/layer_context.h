@@ -6,6 +6,7 @@
 #include "core/base/timestamp.h"
 
 #include "graphics/forwarding.h"
+#include "graphics/base/aabb_tree.h"
 #include "graphics/base/render_layer.h"
 #include "graphics/inf/renderable.h"
 
@@ -17,6 +18,20 @@ class ARK_API LayerContext final  {
 public:
     struct ElementState {
         Optional<element_index_t> _index;
+
+//  Its renderable, the state the renderable reported this frame and its place in the LayerContext's draw order.
+        Renderable* _renderable = nullptr;
+        Renderable::State _state;
+        uint64_t _order = 0;
+
+//  World space AABB from the element's last full snapshot and its proxy in the LayerContext's AABBTree, only maintained while its RenderLayer culls.
+        V3 _aabb_min;
+        V3 _aabb_max;
+        int32_t _aabb_proxy = -1;
+        uint32_t _culling_stamp = 0;
+//  Position in LayerContext::_unculled_element_states, -1 if it isn't in there.
+        int32_t _unculled_index = -1;
+        bool _culled = false;
     };
 
 public:
@@ -46,7 +61,11 @@ public:
 private:
     void updateFrameState(const RenderRequest& renderRequest);
     bool processNewCreated();
-    ElementState& addElementState(void* key);
+    ElementState& addElementState(Renderable& renderable);
+
+    void addUnculled(ElementState& elementState);
+    void removeUnculled(ElementState& elementState);
+    void clearUnculled();
 
 private:
     sp<Shader> _shader;
@@ -63,6 +82,8 @@ private:
     Vector<sp<Renderable>> _newly_created_renderables;
 
     HashMap<const void*, ElementState> _element_states;
+    uint64_t _element_order;
+    AABBTree _aabb_tree;
     struct RenderableState {
         Renderable* _renderable;
         ElementState* _element_state;
@@ -73,8 +94,13 @@ private:
     bool _layer_dirty;
     bool _instances_dirty;
     Vector<RenderableState> _renderable_states;
+    Vector<ElementState*> _dirty_element_states;
     Vector<ElementState> _discarded_element_states;
 
+//  Elements in view at the last cull, so the ones leaving it are found without visiting the others. Only maintained while "_culling" is set.
+    Vector<ElementState*> _unculled_element_states;
+    bool _culling;
+
     Timestamp _timestamp;
 
     friend class RenderLayerSnapshot;
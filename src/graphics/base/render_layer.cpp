@@ -3,6 +3,7 @@
 #include "core/ark.h"
 #include "core/base/named_hash.h"
 #include "core/types/global.h"
+#include "core/util/documents.h"
 
 #include "graphics/base/camera.h"
 #include "graphics/base/layer_context.h"
@@ -20,13 +21,19 @@
 #include "renderer/inf/model_loader.h"
 #include "renderer/inf/drawing_context_composer.h"
 
+#include "app/base/application_context.h"
+#include "app/base/application_manifest.h"
+
 namespace ark {
 
 RenderLayer::Stub::Stub(sp<RenderController> renderController, sp<ModelLoader> modelLoader, sp<Shader> shader, sp<Boolean> visible, sp<Boolean> discarded, sp<Varyings> varyings, sp<Vec4> scissor)
     : _render_controller(std::move(renderController)), _model_loader(ModelLoaderCached::ensureCached(std::move(modelLoader))), _shader(std::move(shader)), _visible(std::move(visible), true),
       _discarded(std::move(discarded), false), _varyings(std::move(varyings)), _scissor(scissor ? std::move(scissor) : sp<Vec4>(_shader->pipelineDesciptor()->scissor())), _is_dynamic_scissor(false), _drawing_context_composer(_model_loader->makeRenderCommandComposer(_shader)),
-      _pipeline_bindings(_drawing_context_composer->makePipelineBindings(_shader, _render_controller, _model_loader->renderMode())), _stride(_shader->layout()->getVertexLayout(0).stride())
+      _pipeline_bindings(_drawing_context_composer->makePipelineBindings(_shader, _render_controller, _model_loader->renderMode())), _stride(_shader->layout()->getVertexLayout(0).stride()),
+      _parallel_chunk_size(Ark::instance().manifest()->renderer()._parallel_compose_chunk_size), _culling_reload(false)
 {
+    if(_parallel_chunk_size)
+        _parallel_executor = Ark::instance().applicationContext()->threadPoolExecutor();
     _model_loader->bind(_pipeline_bindings);
     const PipelineDescriptor::TraitScissorTest* scissorTest = _pipeline_bindings->pipelineDescriptor()->getTrait<PipelineDescriptor::TraitScissorTest>();
     CHECK(!_scissor || scissorTest, "RenderLayer has a scissor but its Shader has no scissor_test trait");
@@ -54,6 +61,8 @@ RenderLayerSnapshot RenderLayer::snapshot(const RenderRequest& renderRequest)
 
     DPROFILER_LOG("Signature", _stub->_pipeline_bindings->pipelineDescriptor()->signature());
     DPROFILER_LOG("verticesDirty", renderLayerSnapshot.verticesDirty());
+    DPROFILER_LOG("culled", renderLayerSnapshot._culled_count);
+    DPROFILER_LOG("drawn", renderLayerSnapshot._elements.size());
     return renderLayerSnapshot;
 }
 
@@ -62,6 +71,17 @@ const sp<ModelLoader>& RenderLayer::modelLoader() const
     return _stub->_model_loader;
 }
 
+bool RenderLayer::culling() const
+{
+    return static_cast<bool>(_stub->_culling_vp);
+}
+
+void RenderLayer::setCulling(const bool culling) const
+{
+    _stub->_culling_vp = culling ? _stub->_shader->camera().vp() : nullptr;
+    _stub->_culling_reload = culling;
+}
+
 sp<Boolean> RenderLayer::visible() const
 {
     return _stub->_visible.toVar();
@@ -122,13 +142,16 @@ RenderLayer::BUILDER::BUILDER(BeanFactory& factory, const document& manifest)
 RenderLayer::BUILDER::BUILDER(BeanFactory& factory, const document& manifest, sp<Builder<ModelLoader>> modelLoader, sp<Builder<Shader>> shader)
     : _model_loader(modelLoader ? std::move(modelLoader) : factory.ensureBuilder<ModelLoader>(manifest, constants::MODEL_LOADER)), _shader(shader ? std::move(shader) : factory.ensureBuilder<Shader>(manifest, constants::SHADER)),
       _varyings(factory.getConcreteClassBuilder<Varyings>(manifest, constants::VARYINGS)), _visible(factory.getBuilder<Boolean>(manifest, constants::VISIBLE)), _discarded(factory.getBuilder<Boolean>(manifest, constants::DISCARDED)),
-      _scissor(factory.getBuilder<Vec4>(manifest, "scissor"))
+      _scissor(factory.getBuilder<Vec4>(manifest, "scissor")), _culling(Documents::getAttribute<bool>(manifest, "culling", false))
 {
 }
 
 sp<RenderLayer> RenderLayer::BUILDER::build(const Scope& args)
 {
-    return sp<RenderLayer>::make(_model_loader->build(args), _shader->build(args), _varyings->build(args), _visible.build(args), _discarded.build(args), _scissor.build(args));
+    sp<RenderLayer> renderLayer = sp<RenderLayer>::make(_model_loader->build(args), _shader->build(args), _varyings->build(args), _visible.build(args), _discarded.build(args), _scissor.build(args));
+    if(_culling)
+        renderLayer->setCulling(true);
+    return renderLayer;
 }
 
 RenderLayer::RENDERER_BUILDER::RENDERER_BUILDER(BeanFactory& factory, const document& manifest)
@@ -33,6 +33,12 @@ public:
         sp<PipelineBindings> _pipeline_bindings;
 
         uint32_t _stride;
+
+        sp<Executor> _parallel_executor;
+        uint32_t _parallel_chunk_size;
+
+        sp<Mat4> _culling_vp;
+        bool _culling_reload;
     };
 
 //  [[script::bindings::auto]]
@@ -63,6 +69,10 @@ public:
 
     void addLayerContext(sp<LayerContext> layerContext);
 
+//  Skips elements whose bounds fall outside the Shader camera's view frustum, before they are snapshotted or written.
+    bool culling() const;
+    void setCulling(bool culling) const;
+
 //  [[plugin::builder]]
     class BUILDER final : public Builder<RenderLayer> {
     public:
@@ -78,6 +88,7 @@ public:
         SafeBuilder<Boolean> _visible;
         SafeBuilder<Boolean> _discarded;
         SafeBuilder<Vec4> _scissor;
+        bool _culling;
     };
 
 //  [[plugin::builder("render-layer")]]
@@ -1,12 +1,20 @@
 #include "graphics/base/render_layer_snapshot.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <limits>
 #include <ranges>
 
+#include "core/ark.h"
 #include "core/util/log.h"
+#include "core/util/parallel_util.h"
 #include "core/util/updatable_util.h"
 
+#include "graphics/base/boundaries.h"
 #include "graphics/base/layer_context.h"
 #include "graphics/base/layer_context_snapshot.h"
+#include "graphics/util/matrix_util.h"
 
 #include "renderer/base/drawing_context.h"
 #include "renderer/base/model.h"
@@ -14,10 +22,73 @@
 #include "renderer/base/render_backend.h"
 #include "renderer/base/shader.h"
 #include "renderer/base/pipeline_bindings.h"
+#include "renderer/base/vertex_writer.h"
 #include "renderer/inf/drawing_context_composer.h"
 
 namespace ark {
 
+namespace {
+
+void updateElementBounds(LayerContext::ElementState& elementState, const Renderable::Snapshot& snapshot)
+{
+    V3 localMin(-std::abs(snapshot._size.x()), -std::abs(snapshot._size.y()), -std::abs(snapshot._size.z()));
+    V3 localMax = -localMin;
+    if(const sp<Boundaries>& content = snapshot._model->content())
+    {
+        const V3 contentMin = content->aabbMin()->val();
+        const V3 contentMax = content->aabbMax()->val();
+        for(size_t i = 0; i < 3; ++i)
+        {
+            localMin[i] = std::min(localMin[i], contentMin[i]);
+            localMax[i] = std::max(localMax[i], contentMax[i]);
+        }
+    }
+
+    const M4 model = snapshot._transform ? MatrixUtil::translate({}, snapshot._position) * snapshot._transform->toMatrix(snapshot._transform_snapshot) : MatrixUtil::translate({}, snapshot._position);
+    V3 aabbMin(std::numeric_limits<float>::max());
+    V3 aabbMax(std::numeric_limits<float>::lowest());
+    for(uint32_t i = 0; i < 8; ++i)
+    {
+        const V4 corner = model * V4(i & 1 ? localMax.x() : localMin.x(), i & 2 ? localMax.y() : localMin.y(), i & 4 ? localMax.z() : localMin.z(), 1.0f);
+        for(size_t j = 0; j < 3; ++j)
+        {
+            aabbMin[j] = std::min(aabbMin[j], corner[j]);
+            aabbMax[j] = std::max(aabbMax[j], corner[j]);
+        }
+    }
+    elementState._aabb_min = aabbMin;
+    elementState._aabb_max = aabbMax;
+}
+
+//  A box is outside only when all eight corners lie outside the same clip plane. Depth is clipped against [-w, w] so it stays conservative for [0, w] clip spaces too.
+AABBTree::Containment classifyFrustum(const M4& vp, const V3& aabbMin, const V3& aabbMax)
+{
+    uint32_t outsideAll = 0x3f;
+    uint32_t outsideAny = 0;
+    for(uint32_t i = 0; i < 8; ++i)
+    {
+        const V4 clip = vp * V4(i & 1 ? aabbMax.x() : aabbMin.x(), i & 2 ? aabbMax.y() : aabbMin.y(), i & 4 ? aabbMax.z() : aabbMin.z(), 1.0f);
+        const float w = clip.w();
+        const uint32_t outside = (clip.x() < -w ? 1 : 0) | (clip.x() > w ? 2 : 0) | (clip.y() < -w ? 4 : 0) | (clip.y() > w ? 8 : 0) | (clip.z() < -w ? 16 : 0) | (clip.z() > w ? 32 : 0);
+        outsideAll &= outside;
+        outsideAny |= outside;
+    }
+    if(outsideAll)
+        return AABBTree::CONTAINMENT_OUTSIDE;
+    return outsideAny ? AABBTree::CONTAINMENT_INTERSECTS : AABBTree::CONTAINMENT_INSIDE;
+}
+
+uint32_t nextCullingStamp()
+{
+    static std::atomic<uint32_t> stamp = 0;
+    uint32_t next = stamp.fetch_add(1, std::memory_order_relaxed) + 1;
+    while(next == 0)
+        next = stamp.fetch_add(1, std::memory_order_relaxed) + 1;
+    return next;
+}
+
+}
+
 class RenderLayerSnapshot::OnceGuard {
 public:
     explicit OnceGuard(const RenderLayerSnapshot& snapshot)
@@ -35,7 +106,7 @@ private:
 };
 
 RenderLayerSnapshot::RenderLayerSnapshot(const RenderRequest& renderRequest, const sp<RenderLayer::Stub>& stub)
-    : _stub(stub), _index_count(0), _vertices_dirty(false), _render_layer_dirty(UpdatableUtil::update(renderRequest.tick(), _stub->_visible, _stub->_scissor))
+    : _stub(stub), _index_count(0), _culled_count(0), _vertices_dirty(false), _render_layer_dirty(UpdatableUtil::update(renderRequest.tick(), _stub->_visible, _stub->_scissor))
 {
     if(_stub->_scissor)
         _scissor = Rect(_stub->_scissor->val());
@@ -103,6 +174,10 @@ void RenderLayerSnapshot::addDiscardedLayerContext(LayerContext& lc)
         _elements_deleted.push_back(std::move(v));
     lc._renderables.clear();
     lc._element_states.clear();
+    lc._renderable_states.clear();
+    lc._dirty_element_states.clear();
+    lc._unculled_element_states.clear();
+    lc._aabb_tree.clear();
 }
 
 bool RenderLayerSnapshot::doAddLayerContext(const RenderRequest& renderRequest, LayerContext& layerContext)
@@ -112,45 +187,236 @@ bool RenderLayerSnapshot::doAddLayerContext(const RenderRequest& renderRequest,
     _layer_context_snapshots.push_back(layerContext.snapshot(renderRequest, shaderLayout));
     const LayerContextSnapshot& layerSnapshot = _layer_context_snapshots.back();
 
+    for(const LayerContext::ElementState& i : layerContext._discarded_element_states)
+        _elements_deleted.push_back(i);
+
+//  Culling layers take their elements from the LayerContext's AABBTree query in cull().
+    if(_stub->_culling_vp)
+    {
+        _culling_layer_contexts.emplace_back(&layerContext, &layerSnapshot);
+        return layerContext._instances_dirty;
+    }
+
+    if(layerContext._culling)
+    {
+        layerContext.clearUnculled();
+        layerContext._culling = false;
+    }
+
     const bool reload = verticesDirty();
+    bool unculled = false;
     for(const LayerContext::RenderableState& i : layerContext._renderable_states)
     {
         Renderable::State state = i._state;
         if(reload)
             state.set(Renderable::RENDERABLE_STATE_DIRTY, true);
+        if(i._element_state->_culled)
+        {
+            state.set(Renderable::RENDERABLE_STATE_NEW, true);
+            i._element_state->_culled = false;
+            unculled = true;
+        }
         _elements.emplace_back(*i._renderable, layerSnapshot, *i._element_state, Renderable::Snapshot{state});
     }
 
-    for(const LayerContext::ElementState& i : layerContext._discarded_element_states)
-        _elements_deleted.push_back(i);
-
-    return layerContext._instances_dirty;
+    return layerContext._instances_dirty || (unculled && !_stub->_drawing_context_composer->keepsElementSlots());
 }
 
 void RenderLayerSnapshot::snapshot(const RenderRequest& renderRequest)
 {
+    if(_stub->_culling_vp)
+        cull(renderRequest);
+
     const bool reload = verticesDirty() || layersDirty();
-    for(Element& i : _elements)
+    std::atomic<size_t> indexCount = 0;
+    forEachElementChunk([this, &renderRequest, &indexCount, reload](const size_t begin, const size_t end) {
+        size_t chunkIndexCount = 0;
+        for(size_t i = begin; i < end; ++i)
+        {
+            const Renderable::Snapshot& snapshot = _elements[i].ensureSnapshot(renderRequest, *this, reload);
+            chunkIndexCount += snapshot._model->indexCount();
+        }
+        indexCount.fetch_add(chunkIndexCount, std::memory_order_relaxed);
+    });
+    _index_count += indexCount.load(std::memory_order_relaxed);
+}
+
+void RenderLayerSnapshot::cull(const RenderRequest& renderRequest)
+{
+    DPROFILER_TRACE("Culling");
+    _stub->_culling_vp->update(renderRequest.tick());
+    const M4 vp = _stub->_culling_vp->val();
+    const bool reload = verticesDirty() || layersDirty() || _stub->_culling_reload;
+    _stub->_culling_reload = false;
+
+    const uint32_t cullingStamp = nextCullingStamp();
+    for(const auto& [layerContext, layerSnapshot] : _culling_layer_contexts)
+        cullLayerContext(renderRequest, *layerContext, *layerSnapshot, vp, cullingStamp, reload);
+}
+
+void RenderLayerSnapshot::cullLayerContext(const RenderRequest& renderRequest, LayerContext& layerContext, const LayerContextSnapshot& layerSnapshot, const M4& vp, const uint32_t cullingStamp, const bool reload)
+{
+//  Bounds come from full snapshots, so only DIRTY elements get new ones, unless the whole layer is reloaded or has just started culling.
+    const bool rebound = reload || !layerContext._culling;
+    std::deque<Element> rebounded;
+    if(rebound)
+    {
+        for(const LayerContext::RenderableState& i : layerContext._renderable_states)
+        {
+            if(!layerContext._culling && !i._element_state->_culled && i._element_state->_unculled_index < 0)
+                layerContext.addUnculled(*i._element_state);
+            if(i._state.contains(Renderable::RENDERABLE_STATE_VISIBLE))
+                rebounded.emplace_back(*i._renderable, layerSnapshot, *i._element_state, Renderable::Snapshot{i._state});
+        }
+        layerContext._culling = true;
+    }
+    else
+        for(LayerContext::ElementState* i : layerContext._dirty_element_states)
+            if(i->_state.contains(Renderable::RENDERABLE_STATE_VISIBLE))
+                rebounded.emplace_back(*i->_renderable, layerSnapshot, *i, Renderable::Snapshot{i->_state});
+
+    forEachChunk(rebounded.size(), [this, &renderRequest, &rebounded, reload](const size_t begin, const size_t end) {
+        for(size_t i = begin; i < end; ++i)
+        {
+            Element& element = rebounded[i];
+            element._snapshot._state.set(Renderable::RENDERABLE_STATE_DIRTY, true);
+            updateElementBounds(element._element_state, element.ensureSnapshot(renderRequest, *this, reload));
+        }
+    });
+
+    HashMap<const LayerContext::ElementState*, Element*> reboundedElements;
+    for(Element& i : rebounded)
     {
-        const Renderable::Snapshot& snapshot = i.ensureSnapshot(renderRequest, *this, reload);
-        _index_count += snapshot._model->indexCount();
+        LayerContext::ElementState& elementState = i._element_state;
+        if(elementState._aabb_proxy < 0)
+            elementState._aabb_proxy = layerContext._aabb_tree.insert(elementState._aabb_min, elementState._aabb_max, &elementState);
+        else
+            layerContext._aabb_tree.update(elementState._aabb_proxy, elementState._aabb_min, elementState._aabb_max);
+        reboundedElements.emplace(&elementState, &i);
     }
+
+    Vector<LayerContext::ElementState*> inView;
+    layerContext._aabb_tree.query([&vp](const V3& aabbMin, const V3& aabbMax) {
+        return classifyFrustum(vp, aabbMin, aabbMax);
+    }, [&vp, &inView, cullingStamp](void* userData, const bool inside) {
+        LayerContext::ElementState& elementState = *static_cast<LayerContext::ElementState*>(userData);
+        if(inside || classifyFrustum(vp, elementState._aabb_min, elementState._aabb_max) != AABBTree::CONTAINMENT_OUTSIDE)
+        {
+            elementState._culling_stamp = cullingStamp;
+            inView.push_back(&elementState);
+        }
+    });
+
+//  Elements leaving the view give their slots back like deleted ones and come back as new ones.
+    bool culledChanged = false;
+    for(size_t i = layerContext._unculled_element_states.size(); i > 0; --i)
+        if(LayerContext::ElementState& elementState = *layerContext._unculled_element_states[i - 1]; elementState._culling_stamp != cullingStamp)
+        {
+            _elements_deleted.push_back(elementState);
+            elementState._index = Optional<element_index_t>();
+            elementState._culled = true;
+            layerContext.removeUnculled(elementState);
+            culledChanged = true;
+        }
+
+    std::sort(inView.begin(), inView.end(), [](const LayerContext::ElementState* a, const LayerContext::ElementState* b) {
+        return a->_order < b->_order;
+    });
+    for(LayerContext::ElementState* i : inView)
+    {
+        const bool entering = i->_culled;
+        if(entering)
+        {
+            i->_culled = false;
+            culledChanged = true;
+        }
+        if(i->_unculled_index < 0)
+            layerContext.addUnculled(*i);
+
+        if(const auto iter = reboundedElements.find(i); iter != reboundedElements.end())
+            _elements.push_back(std::move(*iter->second));
+        else
+        {
+            Renderable::State state = i->_state;
+            if(entering)
+                state.set(Renderable::RENDERABLE_STATE_DIRTY, true);
+            _elements.emplace_back(*i->_renderable, layerSnapshot, *i, Renderable::Snapshot{state});
+        }
+        if(entering)
+            _elements.back()._snapshot._state.set(Renderable::RENDERABLE_STATE_NEW, true);
+    }
+
+//  Composers laying elements out by their position in _elements rewrite the surviving ones on any change to the culled set.
+//  Slot keeping ones just free the slots of the leaving elements and write the entering ones as NEW.
+    if(culledChanged && !_stub->_drawing_context_composer->keepsElementSlots())
+        _vertices_dirty = true;
+    _culled_count += layerContext._renderable_states.size() - inView.size();
+}
+
+void RenderLayerSnapshot::forEachElementChunk(const std::function<void(size_t, size_t)>& func) const
+{
+    forEachChunk(_elements.size(), func);
+}
+
+void RenderLayerSnapshot::forEachChunk(const size_t count, const std::function<void(size_t, size_t)>& func) const
+{
+    if(_stub->_parallel_executor && count > _stub->_parallel_chunk_size)
+        ParallelUtil::forEachChunk(*_stub->_parallel_executor, count, _stub->_parallel_chunk_size, func);
+    else if(count)
+        func(0, count);
+}
+
+void RenderLayerSnapshot::writeElementChunks(const VertexWriter& writer, const size_t verticesPerElement, const std::function<void(VertexWriter&, size_t, size_t)>& func) const
+{
+    forEachElementChunk([&writer, verticesPerElement, &func](const size_t begin, const size_t end) {
+        VertexWriter chunkWriter = writer.slice(begin * verticesPerElement, (end - begin) * verticesPerElement);
+        func(chunkWriter, begin, end);
+    });
+
+#if ARK_FLAG_BUILD_TYPE == 1
+    if(_stub->_parallel_executor && _elements.size() > _stub->_parallel_chunk_size)
+    {
+        Vector<uint8_t> serial(writer.size());
+        {
+            VertexWriter serialWriter = writer.rebind(serial.data());
+            func(serialWriter, 0, _elements.size());
+        }
+        CHECK(std::memcmp(serial.data(), writer.data(), serial.size()) == 0, "Parallel compose of %zu elements differs from the serial one", _elements.size());
+    }
+#endif
 }
 
 RenderLayerSnapshot::Element::Element(Renderable& renderable, const LayerContextSnapshot& layerContext, LayerContext::ElementState& state, const Renderable::Snapshot& snapshot)
-    : _renderable(renderable), _layer_context(layerContext), _element_state(state), _snapshot(snapshot)
+    : _renderable(renderable), _layer_context(layerContext), _element_state(state), _snapshot(snapshot), _snapshotted(false)
 {
 }
 
 const Renderable::Snapshot& RenderLayerSnapshot::Element::ensureSnapshot(const RenderRequest& renderRequest, const RenderLayerSnapshot& renderLayerSnapshot, const bool reload)
 {
+    if(_snapshotted)
+        return _snapshot;
+
     if(reload)
         _snapshot._state.set(Renderable::RENDERABLE_STATE_DIRTY, true);
     _snapshot =_renderable.snapshot(renderLayerSnapshot, renderRequest, _snapshot._state);
     ASSERT(_snapshot._model);
     _snapshot._position += _layer_context._position;
     _snapshot.applyVaryings(_layer_context._varyings);
+    _snapshotted = true;
     return _snapshot;
 }
 
+Renderable::Snapshot RenderLayerSnapshot::Element::takeFullSnapshot(const RenderRequest& renderRequest, const RenderLayerSnapshot& renderLayerSnapshot) const
+{
+    if(_snapshot._state.contains(Renderable::RENDERABLE_STATE_DIRTY))
+        return _snapshot;
+
+    Renderable::State state = _snapshot._state;
+    state.set(Renderable::RENDERABLE_STATE_DIRTY, true);
+    Renderable::Snapshot snapshot = _renderable.snapshot(renderLayerSnapshot, renderRequest, state);
+    snapshot._position += _layer_context._position;
+    snapshot.applyVaryings(_layer_context._varyings);
+    return snapshot;
+}
+
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <deque>
+#include <functional>
 
 #include "core/base/api.h"
 #include "core/inf/array.h"
@@ -24,11 +25,14 @@ public:
         Element(Renderable& renderable, const LayerContextSnapshot& layerContext, LayerContext::ElementState& state, const Renderable::Snapshot& snapshot);
 
         const Renderable::Snapshot& ensureSnapshot(const RenderRequest& renderRequest, const RenderLayerSnapshot& renderLayerSnapshot, bool reload);
+//  Snapshots taken without RENDERABLE_STATE_DIRTY only carry the state, type and model. For those a full one is taken again, without caching it.
+        Renderable::Snapshot takeFullSnapshot(const RenderRequest& renderRequest, const RenderLayerSnapshot& renderLayerSnapshot) const;
 
         Renderable& _renderable;
         const LayerContextSnapshot& _layer_context;
         LayerContext::ElementState& _element_state;
         Renderable::Snapshot _snapshot;
+        bool _snapshotted;
     };
 
 public:
@@ -43,9 +47,17 @@ public:
     void addLayerContext(const RenderRequest& renderRequest, Vector<sp<LayerContext>>& layerContexts);
     void snapshot(const RenderRequest& renderRequest);
 
+//  Calls "func(begin, end)" over consecutive ranges covering _elements, on the thread pool if the layer composes in parallel, otherwise once on the calling thread.
+//  Ranges never overlap, so writing element i to slot i gives the same output either way.
+    void forEachElementChunk(const std::function<void(size_t, size_t)>& func) const;
+//  Fills "writer" with "verticesPerElement" vertices per element by calling "func(chunkWriter, begin, end)" through forEachElementChunk.
+//  Debug builds compose a parallel layer once more serially into scratch memory and CHECK that both come out byte-identical.
+    void writeElementChunks(const VertexWriter& writer, size_t verticesPerElement, const std::function<void(VertexWriter&, size_t, size_t)>& func) const;
+
     sp<RenderLayer::Stub> _stub;
 
     size_t _index_count;
+    size_t _culled_count;
 
     std::deque<Element> _elements;
     std::deque<LayerContext::ElementState> _elements_deleted;
@@ -57,11 +69,16 @@ public:
 
 private:
     List<LayerContextSnapshot> _layer_context_snapshots;
+    Vector<std::pair<LayerContext*, const LayerContextSnapshot*>> _culling_layer_contexts;
     class OnceGuard;
 
 private:
     RenderLayerSnapshot(const RenderRequest& renderRequest, const sp<RenderLayer::Stub>& stub);
 
+    void cull(const RenderRequest& renderRequest);
+    void cullLayerContext(const RenderRequest& renderRequest, LayerContext& layerContext, const LayerContextSnapshot& layerSnapshot, const M4& vp, uint32_t cullingStamp, bool reload);
+    void forEachChunk(size_t count, const std::function<void(size_t, size_t)>& func) const;
+
     bool doAddLayerContext(const RenderRequest& renderRequest, LayerContext& layerContext);
     void addDiscardedLayerContext(LayerContext& lc);
 
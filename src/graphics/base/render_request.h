@@ -13,7 +13,7 @@ namespace ark {
 class ARK_API RenderRequest {
 public:
     RenderRequest() = default;
-    RenderRequest(uint32_t tick);
+    RenderRequest(uint32_t tick, sp<Allocator::Pool> allocatorPool = nullptr);
     DEFAULT_COPY_AND_ASSIGN_NOEXCEPT(RenderRequest);
 
     uint32_t tick() const;
@@ -23,7 +23,7 @@ public:
     void addRenderCommand(sp<RenderCommand> renderCommand) const;
 
     struct Stub {
-        Stub(uint32_t tick);
+        Stub(uint32_t tick, sp<Allocator::Pool> allocatorPool);
 
         uint32_t _tick;
         Allocator _allocator;
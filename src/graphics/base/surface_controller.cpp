@@ -1,6 +1,6 @@
 #include "graphics/base/surface_controller.h"
 
-#include <thread>
+#include <chrono>
 
 #include "core/ark.h"
 #include "core/base/clock.h"
@@ -10,7 +10,17 @@
 
 namespace ark {
 
-SurfaceController::SurfaceController()
+namespace {
+
+uint64_t steadyClockNanoseconds()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}
+
+SurfaceController::SurfaceController(const uint32_t inFlightFrames, const bool dropStaleFrames)
+    : _in_flight_frames(std::max<uint32_t>(inFlightFrames, 1)), _drop_stale_frames(dropStaleFrames), _allocator_pool(sp<Allocator::Pool>::make()), _render_requests(_in_flight_frames), _pending_frames(0)
 {
 }
 
@@ -22,20 +32,61 @@ void SurfaceController::addRenderer(sp<Renderer> renderer, sp<Boolean> discarded
 void SurfaceController::requestRender(const uint32_t tick)
 {
     const V3 position(0);
-    RenderRequest renderRequest(tick);
+    RenderRequest renderRequest(tick, _allocator_pool);
     _renderer_phrase.render(renderRequest, position, nullptr);
-    _render_requests.push(std::move(renderRequest));
+
+    const bool pushed = _render_requests.tryPush({std::move(renderRequest), steadyClockNanoseconds()});
+    CHECK(pushed, "Render request overflow, more than %d frames in flight", _render_requests.capacity());
+    ++ _stats._frames_requested;
+
+    _pending_frames.fetch_add(1, std::memory_order_release);
+    _pending_frames.notify_one();
+}
+
+uint32_t SurfaceController::inFlightFrames() const
+{
+    return _in_flight_frames;
 }
 
-RenderRequest SurfaceController::obtainRenderRequest()
+const SurfaceController::Stats& SurfaceController::stats() const
+{
+    return _stats;
+}
+
+const sp<Allocator::Pool>& SurfaceController::allocatorPool() const
+{
+    return _allocator_pool;
+}
+
+std::pair<RenderRequest, uint32_t> SurfaceController::obtainRenderRequest()
 {
     DPROFILER_TRACE("obtainRenderRequest", ApplicationProfiler::CATEGORY_WAIT);
-    while(true)
+    const uint64_t waitBegin = steadyClockNanoseconds();
+    uint32_t pendingFrames = _pending_frames.load(std::memory_order_acquire);
+    while(pendingFrames == 0)
     {
-        if(Optional<RenderRequest> optRequest = _render_requests.pop())
-            return std::move(optRequest.value());
-        std::this_thread::yield();
+        _pending_frames.wait(0, std::memory_order_acquire);
+        pendingFrames = _pending_frames.load(std::memory_order_acquire);
     }
+    const uint64_t waitEnd = steadyClockNanoseconds();
+
+    const uint32_t consumed = _drop_stale_frames ? pendingFrames : 1;
+    _pending_frames.fetch_sub(consumed, std::memory_order_relaxed);
+
+    Optional<PendingFrame> frame;
+    for(uint32_t i = 0; i < consumed; ++i)
+        frame = _render_requests.pop();
+    ASSERT(frame);
+
+    const uint64_t latency = waitEnd - frame->_requested_at;
+    ++ _stats._frames_rendered;
+    _stats._frames_dropped += consumed - 1;
+    _stats._latency_ns.store(latency, std::memory_order_relaxed);
+    _stats._max_latency_ns.store(std::max(latency, _stats._max_latency_ns.load(std::memory_order_relaxed)), std::memory_order_relaxed);
+    _stats._waited_ns += waitEnd - waitBegin;
+    DPROFILER_LOG("FrameLatency", latency);
+
+    return {std::move(frame->_render_request), consumed};
 }
 
 }
@@ -1,32 +1,62 @@
 #pragma once
 
+#include <atomic>
+
 #include "core/forwarding.h"
 #include "core/base/api.h"
 #include "core/base/allocator.h"
-#include "core/concurrent/lf_queue.h"
+#include "core/concurrent/lf_ring_queue.h"
 #include "core/types/shared_ptr.h"
 
 #include "graphics/forwarding.h"
+#include "graphics/base/render_request.h"
 #include "graphics/impl/renderer/render_group.h"
 
 namespace ark {
 
 class ARK_API SurfaceController {
 public:
-    SurfaceController();
+    struct Stats {
+        std::atomic<uint64_t> _frames_requested = 0;
+        std::atomic<uint64_t> _frames_rendered = 0;
+        std::atomic<uint64_t> _frames_dropped = 0;
+        std::atomic<uint64_t> _latency_ns = 0;
+        std::atomic<uint64_t> _max_latency_ns = 0;
+        std::atomic<uint64_t> _waited_ns = 0;
+    };
+
+    SurfaceController(uint32_t inFlightFrames = 1, bool dropStaleFrames = false);
 
 // [[script::bindings::auto]]
     void addRenderer(sp<Renderer> renderer, sp<Boolean> discarded = nullptr, RendererType::Priority priority = RendererType::PRIORITY_DEFAULT);
 
     void requestRender(uint32_t tick);
 
+    uint32_t inFlightFrames() const;
+    const Stats& stats() const;
+
+    const sp<Allocator::Pool>& allocatorPool() const;
+
 private:
-    RenderRequest obtainRenderRequest();
+    struct PendingFrame {
+        RenderRequest _render_request;
+        uint64_t _requested_at;
+    };
+
+//  Blocks the render thread until the core thread publishes a frame. Returns the frame to render and how many queued frames were consumed, stale ones included.
+    std::pair<RenderRequest, uint32_t> obtainRenderRequest();
 
 private:
-    LFQueue<RenderRequest> _render_requests;
+    uint32_t _in_flight_frames;
+    bool _drop_stale_frames;
+
+    sp<Allocator::Pool> _allocator_pool;
+    LFRingQueue<PendingFrame> _render_requests;
+    std::atomic<uint32_t> _pending_frames;
     RenderGroup _renderer_phrase;
 
+    Stats _stats;
+
     friend class Surface;
 };
 
@@ -7,6 +7,7 @@
 #include "core/base/json.h"
 #include "core/inf/storage.h"
 #include "core/inf/variable.h"
+#include "core/util/documents.h"
 #include "core/util/math.h"
 
 #include "graphics/base/layer_context.h"
@@ -165,7 +166,7 @@ sp<CollisionFilter> toCollisionFilter(const sp<Json>& jCollisionFilter)
 }
 
 Tilemap::Tilemap(sp<Tileset> tileset, sp<Importer<Tilemap>> importer, sp<Outputer<Tilemap>> outputer)
-    : _tileset(std::move(tileset)), _storage(sp<TilemapStorage>::make(*this, std::move(importer), std::move(outputer)))
+    : _tileset(std::move(tileset)), _storage(sp<TilemapStorage>::make(*this, std::move(importer), std::move(outputer))), _chunk_size(0)
 {
 }
 
@@ -184,6 +185,18 @@ const sp<Storage>& Tilemap::storage() const
     return _storage;
 }
 
+uint32_t Tilemap::chunkSize() const
+{
+    return _chunk_size;
+}
+
+void Tilemap::setChunkSize(const uint32_t chunkSize)
+{
+    _chunk_size = chunkSize;
+    for(const sp<TilemapLayer>& i : _layers)
+        i->setChunkSize(chunkSize);
+}
+
 void Tilemap::load(const sp<Readable>& src)
 {
     _storage->import(src);
@@ -197,6 +210,7 @@ void Tilemap::load(const String& src)
 sp<TilemapLayer> Tilemap::makeLayer(const String& name, uint32_t colCount, uint32_t rowCount, sp<Vec3> position, sp<Boolean> visible, sp<CollisionFilter> collisionFilter, float zorder)
 {
     sp<TilemapLayer> layer = sp<TilemapLayer>::make(_tileset, name, colCount, rowCount, position, std::move(visible), std::move(collisionFilter));
+    layer->setChunkSize(_chunk_size);
     addLayer(layer, zorder);
     return layer;
 }
@@ -300,13 +314,15 @@ const Vector<sp<TilemapLayer>>& Tilemap::layers() const
 }
 
 Tilemap::BUILDER::BUILDER(BeanFactory& factory, const document& manifest)
-    : _tileset(factory.ensureBuilder<Tileset>(manifest, "tileset")), _importer(factory.getBuilder<Importer<Tilemap>>(manifest, "importer")), _outputer(factory.getBuilder<Outputer<Tilemap>>(manifest, "outputer"))
+    : _tileset(factory.ensureBuilder<Tileset>(manifest, "tileset")), _importer(factory.getBuilder<Importer<Tilemap>>(manifest, "importer")), _outputer(factory.getBuilder<Outputer<Tilemap>>(manifest, "outputer")),
+      _chunk_size(Documents::getAttribute<uint32_t>(manifest, "chunk-size", 0))
 {
 }
 
 sp<Tilemap> Tilemap::BUILDER::build(const Scope& args)
 {
     sp<Tilemap> tilemap = sp<Tilemap>::make(_tileset->build(args), _importer.build(args), _outputer.build(args));
+    tilemap->setChunkSize(_chunk_size);
     return tilemap;
 }
 
@@ -22,6 +22,12 @@ public:
 // [[script::bindings::property]]
     const sp<Storage>& storage() const;
 
+//  Chunk size given to the layers of this Tilemap, see TilemapLayer::setChunkSize.
+// [[script::bindings::property]]
+    uint32_t chunkSize() const;
+// [[script::bindings::property]]
+    void setChunkSize(uint32_t chunkSize);
+
 // [[script::bindings::auto]]
     sp<TilemapLayer> makeLayer(const String& name, uint32_t colCount, uint32_t rowCount, sp<Vec3> position = nullptr, sp<Boolean> visible = nullptr, sp<CollisionFilter> collisionFilter = nullptr, float zorder = 0);
 
@@ -55,11 +61,13 @@ public:
         sp<Builder<Tileset>> _tileset;
         SafeBuilder<Importer<Tilemap>> _importer;
         SafeBuilder<Outputer<Tilemap>> _outputer;
+        uint32_t _chunk_size;
     };
 
 private:
     sp<Tileset> _tileset;
     sp<Storage> _storage;
+    uint32_t _chunk_size;
 
     Vector<sp<TilemapLayer>> _layers;
 
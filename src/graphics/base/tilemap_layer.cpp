@@ -1,25 +1,59 @@
 #include "graphics/base/tilemap_layer.h"
 
 #include <algorithm>
+#include <limits>
 
 #include "core/ark.h"
 
 #include "core/inf/variable.h"
 #include "core/impl/boolean/boolean_by_weak_ref.h"
+#include "core/impl/uploader/uploader_array.h"
 #include "core/util/math.h"
 
+#include "graphics/base/boundaries.h"
 #include "graphics/base/layer_context.h"
+#include "graphics/base/render_layer_snapshot.h"
+#include "graphics/base/render_request.h"
 #include "graphics/components/render_object.h"
 #include "graphics/components/size.h"
 #include "graphics/base/tile.h"
 #include "graphics/base/tilemap.h"
 #include "graphics/base/tileset.h"
+#include "graphics/impl/transform/transform_impl.h"
 
 #include "renderer/base/shader.h"
 #include "renderer/base/model.h"
+#include "renderer/base/pipeline_bindings.h"
+#include "renderer/base/pipeline_descriptor.h"
+#include "renderer/base/pipeline_layout.h"
+#include "renderer/base/vertex_writer.h"
+#include "renderer/inf/vertices.h"
 
 namespace ark {
 
+namespace {
+
+class VerticesBaked final : public Vertices {
+public:
+    VerticesBaked(Vector<uint8_t> content, const uint32_t stride)
+        : Vertices(content.size() / stride), _content(std::move(content)), _stride(stride) {
+    }
+
+    void write(VertexWriter& buf, const V3& /*size*/) override {
+        DCHECK(buf.stride() == _stride, "Stride mismatch: baked %d, writer %d", _stride, buf.stride());
+        for(size_t i = 0; i < length(); ++i) {
+            buf.next();
+            buf.write(_content.data() + i * _stride, _stride, 0);
+        }
+    }
+
+private:
+    Vector<uint8_t> _content;
+    uint32_t _stride;
+};
+
+}
+
 struct TilemapLayer::Stub {
     size_t _col_count;
     size_t _row_count;
@@ -62,9 +96,133 @@ struct TilemapLayer::RenderableTile final : Renderable {
     V3 _position;
 };
 
+struct TilemapLayer::RenderableChunk final : Renderable {
+    RenderableChunk(const sp<Stub>& stub, Vector<sp<RenderableTile>> tiles)
+        : _stub(stub), _tiles(std::move(tiles)), _tile_states(_tiles.size()), _transform(sp<Transform>::make<TransformImpl>(TransformType::TYPE_LINEAR_3D)), _visible(false), _disposed(false)
+    {
+    }
+
+    State updateState(const RenderRequest& renderRequest) override
+    {
+        if(_disposed)
+            return {RENDERABLE_STATE_DISCARDED};
+        if(_model)
+            return {RENDERABLE_STATE_VISIBLE};
+
+        bool visible = false;
+        bool alive = false;
+        for(size_t i = 0; i < _tiles.size(); ++i)
+            if(const sp<RenderableTile>& tile = _tiles.at(i))
+            {
+                _tile_states[i] = tile->updateState(renderRequest);
+                alive = alive || !_tile_states[i].contains(RENDERABLE_STATE_DISCARDED);
+                visible = visible || _tile_states[i].contains(RENDERABLE_STATE_VISIBLE);
+            }
+        if(!alive)
+        {
+            _disposed = true;
+            return {RENDERABLE_STATE_DISCARDED};
+        }
+
+//  A chunk whose tiles are all hidden stays unbaked, so it gets baked once they show up again.
+        const bool dirty = visible != _visible;
+        _visible = visible;
+        return {dirty ? RENDERABLE_STATE_DIRTY : RENDERABLE_STATE_NONE, visible ? RENDERABLE_STATE_VISIBLE : RENDERABLE_STATE_NONE};
+    }
+
+    Snapshot snapshot(const RenderLayerSnapshot& renderLayerSnapshot, const RenderRequest& renderRequest, const State state) override
+    {
+        if(!_model && state.contains(RENDERABLE_STATE_VISIBLE))
+            _model = bake(renderLayerSnapshot, renderRequest);
+        else if(!_model && !_hidden_model)
+            _hidden_model = bake(renderLayerSnapshot, renderRequest);
+
+        const sp<Model>& model = _model ? _model : _hidden_model;
+        if(state.contains(RENDERABLE_STATE_DIRTY))
+            return {state, 0, model, V3(0, 0, _stub->_zorder), V3(0), _transform, _transform->snapshot()};
+        return {state, 0, model};
+    }
+
+//  Tiles can be changed in place until the chunk gets baked, after that it has to be replaced by a new one.
+    bool isMutable() const
+    {
+        return !_model && !_disposed;
+    }
+
+    void dispose()
+    {
+        _disposed = true;
+    }
+
+//  Writes the visible tiles into one vertex strip in layer space. The model is static, later changes to the tiles' RenderObjects are not picked up.
+    sp<Model> bake(const RenderLayerSnapshot& renderLayerSnapshot, const RenderRequest& renderRequest) const
+    {
+        const RenderLayer::Stub& renderLayer = *renderLayerSnapshot._stub;
+        const PipelineLayout& pipelineLayout = *renderLayer._pipeline_bindings->pipelineLayout();
+        const Varyings::Snapshot defaultVaryings = pipelineLayout.defaultVaryings()->snapshot(pipelineLayout, renderRequest.allocator());
+
+        size_t vertexCount = 0;
+        size_t indexCount = 0;
+        Vector<Snapshot> snapshots;
+        for(size_t i = 0; i < _tiles.size(); ++i)
+            if(_tiles.at(i) && _tile_states.at(i).contains(RENDERABLE_STATE_VISIBLE))
+            {
+                const RenderableTile& tile = *_tiles.at(i);
+                State tileState = _tile_states.at(i);
+                tileState.set(RENDERABLE_STATE_DIRTY, true);
+                Snapshot snapshot = tile._renderable->snapshot(renderLayerSnapshot, renderRequest, tileState);
+                snapshot._position += tile._position;
+                snapshot.applyVaryings(defaultVaryings);
+                vertexCount += snapshot._model->vertexCount();
+                indexCount += snapshot._model->indexCount();
+                snapshots.push_back(std::move(snapshot));
+            }
+
+        const uint32_t stride = renderLayer._stride;
+        Vector<uint8_t> vertices(vertexCount * stride, 0);
+        Vector<element_index_t> indices(indexCount);
+        {
+            VertexWriter writer(renderLayer._pipeline_bindings->pipelineDescriptor()->vertexDescriptor(), true, static_cast<uint32_t>(vertices.size()), stride, vertices.data());
+            element_index_t vertexOffset = 0;
+            element_index_t indexOffset = 0;
+            for(const Snapshot& i : snapshots)
+            {
+                i._model->writeRenderable(writer, i);
+                indexOffset += i._model->writeIndices(indices.data() + indexOffset, vertexOffset);
+                vertexOffset += static_cast<element_index_t>(i._model->vertexCount());
+            }
+        }
+
+        V3 aabbMin(std::numeric_limits<float>::max());
+        V3 aabbMax(std::numeric_limits<float>::lowest());
+        for(size_t i = 0; i < vertexCount; ++i)
+        {
+            V3 position;
+            memcpy(&position, vertices.data() + i * stride, sizeof(V3));
+            for(size_t j = 0; j < 3; ++j)
+            {
+                aabbMin[j] = std::min(aabbMin[j], position[j]);
+                aabbMax[j] = std::max(aabbMax[j], position[j]);
+            }
+        }
+        return sp<Model>::make(sp<Uploader>::make<UploaderArray<element_index_t>>(std::move(indices)), sp<Vertices>::make<VerticesBaked>(std::move(vertices), stride), sp<Boundaries>::make(aabbMin, aabbMax));
+    }
+
+    sp<Stub> _stub;
+    Vector<sp<RenderableTile>> _tiles;
+    Vector<State> _tile_states;
+    sp<Transform> _transform;
+    sp<Model> _model;
+//  Empty, stands in for the model while every tile is hidden.
+    sp<Model> _hidden_model;
+    bool _visible;
+    bool _disposed;
+};
+
 TilemapLayer::TilemapLayer(sp<Tileset> tileset, String name, uint32_t colCount, uint32_t rowCount, sp<Vec3> position, sp<Boolean> visible, sp<CollisionFilter> collisionFilter)
     : _name(std::move(name)), _col_count(colCount), _row_count(rowCount), _size(sp<Size>::make(tileset->tileWidth() * colCount, tileset->tileHeight() * rowCount)), _visible(std::move(visible), true),
-      _collision_filter(std::move(collisionFilter)), _stub(sp<Stub>::make(Stub{colCount, rowCount, std::move(tileset), std::move(position), 0})), _layer_tiles(colCount * rowCount)
+      _collision_filter(std::move(collisionFilter)), _stub(sp<Stub>::make(Stub{colCount, rowCount, std::move(tileset), std::move(position), 0})), _layer_tiles(colCount * rowCount),
+      _chunk_size(0), _chunk_col_count(0)
 {
 }
 
@@ -218,6 +376,8 @@ void TilemapLayer::resize(uint32_t colCount, uint32_t rowCount, uint32_t offsetX
     CHECK(offsetX <= (colCount - _col_count) && offsetY <= (rowCount - _row_count), "Offset position out of bounds(%d, %d)", offsetX, offsetY);
     const bool positionChanged = offsetX || offsetY;
     const float tileWidth = _stub->_tileset->tileWidth(), tileHeight = _stub->_tileset->tileWidth();
+    if(_chunk_size)
+        detachRenderables();
     Stub stub{colCount, rowCount, std::move(_stub->_tileset), std::move(_stub->_position), _stub->_zorder};
 
     std::vector<sp<RenderableTile>> layerTiles(colCount * rowCount);
@@ -240,13 +400,17 @@ void TilemapLayer::resize(uint32_t colCount, uint32_t rowCount, uint32_t offsetX
     _size->setWidth(_stub->_tileset->tileWidth() * colCount);
     _size->setHeight(_stub->_tileset->tileHeight() * rowCount);
     _layer_tiles = std::move(layerTiles);
+    if(_chunk_size)
+        attachRenderables();
     if(_layer_context && positionChanged)
         _layer_context->markDirty();
 }
 
 void TilemapLayer::clear()
 {
+    detachRenderables();
     std::fill(_layer_tiles.begin(), _layer_tiles.end(), nullptr);
+    attachRenderables();
 }
 
 void TilemapLayer::foreachTile(const std::function<bool (uint32_t, uint32_t, const sp<Tile>&)>& callback) const
@@ -271,6 +435,12 @@ void TilemapLayer::setTile(uint32_t col, uint32_t row, const sp<Tile>& tile, con
     const float dy = static_cast<float>(row) * tileHeight + tileHeight / 2;
     sp<RenderableTile> renderableTile = ro ? sp<RenderableTile>::make(_stub, std::move(tileDup), ro, V3(dx, dy, 0.0)) : nullptr;
     sp<RenderableTile>& targetTile = _layer_tiles[index];
+    if(_chunk_size)
+    {
+        targetTile = std::move(renderableTile);
+        updateChunk(col, row, targetTile);
+        return;
+    }
     if(targetTile)
         targetTile->dispose();
     if(_layer_context && renderableTile)
@@ -295,10 +465,105 @@ const sp<LayerContext>& TilemapLayer::layerContext() const
 
 void TilemapLayer::setLayerContext(sp<LayerContext> layerContext)
 {
+    detachRenderables();
     _layer_context = std::move(layerContext);
-    for(const sp<RenderableTile>& i : _layer_tiles)
-        if(i)
-            _layer_context->pushBack(i);
+    attachRenderables();
+}
+
+uint32_t TilemapLayer::chunkSize() const
+{
+    return _chunk_size;
+}
+
+void TilemapLayer::setChunkSize(const uint32_t chunkSize)
+{
+    if(chunkSize == _chunk_size)
+        return;
+
+    detachRenderables();
+    _chunk_size = chunkSize;
+    attachRenderables();
+}
+
+void TilemapLayer::attachRenderables()
+{
+    if(_chunk_size)
+    {
+        _chunk_col_count = (_col_count + _chunk_size - 1) / _chunk_size;
+        const uint32_t chunkRowCount = (_row_count + _chunk_size - 1) / _chunk_size;
+        _layer_chunks.resize(_chunk_col_count * chunkRowCount);
+        for(uint32_t i = 0; i < chunkRowCount; ++i)
+            for(uint32_t j = 0; j < _chunk_col_count; ++j)
+            {
+                sp<RenderableChunk>& chunk = _layer_chunks[i * _chunk_col_count + j];
+                chunk = makeChunk(j, i);
+                if(chunk && _layer_context)
+                    _layer_context->pushBack(chunk);
+            }
+    }
+    else if(_layer_context)
+        for(const sp<RenderableTile>& i : _layer_tiles)
+            if(i)
+                _layer_context->pushBack(i);
+}
+
+void TilemapLayer::detachRenderables()
+{
+    if(_chunk_size)
+    {
+        for(const sp<RenderableChunk>& i : _layer_chunks)
+            if(i)
+                i->dispose();
+        _layer_chunks.clear();
+    }
+    else if(_layer_context)
+    {
+//  A disposed RenderableTile can't be rendered anymore, the layer keeps a fresh copy of it
+        for(sp<RenderableTile>& i : _layer_tiles)
+            if(i)
+            {
+                sp<RenderableTile> renderableTile = sp<RenderableTile>::make(*i);
+                i->dispose();
+                i = std::move(renderableTile);
+            }
+    }
+}
+
+void TilemapLayer::updateChunk(const uint32_t col, const uint32_t row, const sp<RenderableTile>& renderableTile)
+{
+    const uint32_t chunkCol = col / _chunk_size;
+    const uint32_t chunkRow = row / _chunk_size;
+    sp<RenderableChunk>& chunk = _layer_chunks[chunkRow * _chunk_col_count + chunkCol];
+    if(chunk && chunk->isMutable())
+    {
+        chunk->_tiles[(row % _chunk_size) * _chunk_size + col % _chunk_size] = renderableTile;
+        return;
+    }
+
+    if(chunk)
+        chunk->dispose();
+    chunk = makeChunk(chunkCol, chunkRow);
+    if(chunk && _layer_context)
+        _layer_context->pushBack(chunk);
+}
+
+sp<TilemapLayer::RenderableChunk> TilemapLayer::makeChunk(const uint32_t chunkCol, const uint32_t chunkRow) const
+{
+    bool empty = true;
+    Vector<sp<RenderableTile>> tiles(_chunk_size * _chunk_size);
+    for(uint32_t i = 0; i < _chunk_size; ++i)
+        for(uint32_t j = 0; j < _chunk_size; ++j)
+        {
+            const uint32_t row = chunkRow * _chunk_size + i;
+            const uint32_t col = chunkCol * _chunk_size + j;
+            if(row < _row_count && col < _col_count)
+                if(const sp<RenderableTile>& renderableTile = _layer_tiles.at(row * _col_count + col))
+                {
+                    tiles[i * _chunk_size + j] = renderableTile;
+                    empty = false;
+                }
+        }
+    return empty ? nullptr : sp<RenderableChunk>::make(_stub, std::move(tiles));
 }
 
 }
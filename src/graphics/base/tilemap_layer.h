@@ -43,6 +43,13 @@ public:
     const sp<LayerContext>& layerContext() const;
     void setLayerContext(sp<LayerContext> layerContext);
 
+//  Tiles are baked into one Renderable per chunkSize x chunkSize block of cells when it's non-zero, a chunk is rebuilt only when one of its cells changes.
+//  Baking needs a composer that takes models of any vertex count, like the one of the quad and nine-patch model loaders.
+// [[script::bindings::property]]
+    uint32_t chunkSize() const;
+// [[script::bindings::property]]
+    void setChunkSize(uint32_t chunkSize);
+
 // [[script::bindings::property]]
     uint32_t colCount() const;
 // [[script::bindings::property]]
@@ -78,10 +85,17 @@ public:
     void foreachTile(const std::function<bool(uint32_t, uint32_t, const sp<Tile>&)>& callback) const;
 
 private:
-    void setTile(uint32_t col, uint32_t row, const sp<Tile>& tile, const sp<RenderObject>& renderObject);
-
     struct Stub;
     struct RenderableTile;
+    struct RenderableChunk;
+
+    void setTile(uint32_t col, uint32_t row, const sp<Tile>& tile, const sp<RenderObject>& renderObject);
+
+    void attachRenderables();
+    void detachRenderables();
+
+    void updateChunk(uint32_t col, uint32_t row, const sp<RenderableTile>& renderableTile);
+    sp<RenderableChunk> makeChunk(uint32_t chunkCol, uint32_t chunkRow) const;
 
 private:
     String _name;
@@ -97,6 +111,10 @@ private:
 
     std::vector<sp<RenderableTile>> _layer_tiles;
 
+    uint32_t _chunk_size;
+    uint32_t _chunk_col_count;
+    Vector<sp<RenderableChunk>> _layer_chunks;
+
     friend class Tilemap;
 
 };
@@ -40,6 +40,12 @@ public:
     {
         return {};
     }
+
+    void transformPositions(const Snapshot& /*snapshot*/, const V3& translation, uint8_t* positions, const size_t count, const size_t stride) override
+    {
+        for(size_t i = 0; i < count; ++i, positions += stride)
+            *reinterpret_cast<V3*>(positions) += translation;
+    }
 };
 
 }
@@ -106,6 +112,11 @@ M4 TransformImpl::toMatrix(const Snapshot& snapshot)
     return _wrapped->toMatrix(snapshot);
 }
 
+void TransformImpl::transformPositions(const Snapshot& snapshot, const V3& translation, uint8_t* positions, const size_t count, const size_t stride)
+{
+    _wrapped->transformPositions(snapshot, translation, positions, count, stride);
+}
+
 bool TransformImpl::update(uint32_t tick)
 {
     return _wrapped->update(tick);
@@ -25,6 +25,7 @@ public:
     Snapshot snapshot() override;
     V4 transform(const Snapshot& snapshot, const V4& xyzw) override;
     M4 toMatrix(const Snapshot& snapshot) override;
+    void transformPositions(const Snapshot& snapshot, const V3& translation, uint8_t* positions, size_t count, size_t stride) override;
 
     void setRotation(sp<Vec4> rotation);
     void setScale(sp<Vec3> scale);
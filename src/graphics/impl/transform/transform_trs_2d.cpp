@@ -42,4 +42,18 @@ M4 TransformTRS2D::toMatrix(const Snapshot& snapshot)
     return matrix;
 }
 
+void TransformTRS2D::transformPositions(const Snapshot& snapshot, const V3& translation, uint8_t* positions, const size_t count, const size_t stride)
+{
+    const float* mat3 = snapshot.data<M3>().value();
+    M4 matrix;
+    float* mat4 = matrix.value();
+    mat4[0] = mat3[0];
+    mat4[1] = mat3[1];
+    mat4[4] = mat3[3];
+    mat4[5] = mat3[4];
+    mat4[12] = mat3[6];
+    mat4[13] = mat3[7];
+    MatrixUtil::transformPositions(matrix, translation, positions, count, stride);
+}
+
 }
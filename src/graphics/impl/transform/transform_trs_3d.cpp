@@ -32,4 +32,9 @@ M4 TransformTRS3D::toMatrix(const Snapshot& snapshot)
     return snapshot.data<M4>();
 }
 
+void TransformTRS3D::transformPositions(const Snapshot& snapshot, const V3& translation, uint8_t* positions, const size_t count, const size_t stride)
+{
+    MatrixUtil::transformPositions(snapshot.data<M4>(), translation, positions, count, stride);
+}
+
 }
@@ -45,4 +45,9 @@ M4 TransformTS2D::toMatrix(const Snapshot& snapshot)
     return MatrixUtil::translate(MatrixUtil::scale({}, V3(data._scale.x(), data._scale.y(), 1.0f)), -V3(data._pivot, 0));
 }
 
+void TransformTS2D::transformPositions(const Snapshot& snapshot, const V3& translation, uint8_t* positions, const size_t count, const size_t stride)
+{
+    MatrixUtil::transformPositions(toMatrix(snapshot), translation, positions, count, stride);
+}
+
 }
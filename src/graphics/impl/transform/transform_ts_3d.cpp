@@ -43,4 +43,9 @@ M4 TransformTS3D::toMatrix(const Snapshot& snapshot)
     return MatrixUtil::translate(MatrixUtil::scale(M4::identity(), data._scale), data._translation);
 }
 
+void TransformTS3D::transformPositions(const Snapshot& snapshot, const V3& translation, uint8_t* positions, const size_t count, const size_t stride)
+{
+    MatrixUtil::transformPositions(toMatrix(snapshot), translation, positions, count, stride);
+}
+
 }
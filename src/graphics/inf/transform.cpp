@@ -3,6 +3,7 @@
 #include "core/base/constants.h"
 #include "core/util/updatable_util.h"
 
+#include "graphics/base/v4.h"
 #include "graphics/components/rotation.h"
 #include "graphics/components/scale.h"
 
@@ -33,6 +34,15 @@ const OptionalVar<Vec3>& Transform::translation() const
     return _stub->_pivot;
 }
 
+void Transform::transformPositions(const Snapshot& snapshot, const V3& translation, uint8_t* positions, const size_t count, const size_t stride)
+{
+    for(size_t i = 0; i < count; ++i, positions += stride)
+    {
+        V3& position = *reinterpret_cast<V3*>(positions);
+        position = transform(snapshot, V4(position, 1.0f)).toNonHomogeneous() + translation;
+    }
+}
+
 void Transform::onPoll(WiringContext& context)
 {
     if(!context.hasInterface<Rotation>())
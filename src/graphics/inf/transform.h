@@ -62,6 +62,9 @@ public:
     virtual V4 transform(const Snapshot& snapshot, const V4& xyzw) = 0;
     virtual M4 toMatrix(const Snapshot& snapshot) = 0;
 
+//  Batched form of transform(): rewrites "count" positions, laid out every "stride" bytes, in place and offsets them by "translation".
+    virtual void transformPositions(const Snapshot& snapshot, const V3& translation, uint8_t* positions, size_t count, size_t stride);
+
     M4 val() override {
         return toMatrix(snapshot());
     }
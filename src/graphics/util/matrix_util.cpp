@@ -1,5 +1,10 @@
 #include "graphics/util/matrix_util.h"
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define ARK_MATRIX_UTIL_USE_SSE
+#endif
+
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtx/matrix_transform_2d.hpp>
@@ -137,6 +142,34 @@ V3 MatrixUtil::transform(const M4& matrix, const V3& pos, const V3& org)
     return transform(matrix, pos - org) + org;
 }
 
+void MatrixUtil::transformPositions(const M4& affine, const V3& translation, uint8_t* positions, const size_t count, const size_t stride)
+{
+    const float* m = affine.value();
+#ifdef ARK_MATRIX_UTIL_USE_SSE
+    const __m128 col0 = _mm_loadu_ps(m);
+    const __m128 col1 = _mm_loadu_ps(m + 4);
+    const __m128 col2 = _mm_loadu_ps(m + 8);
+    const __m128 col3 = _mm_add_ps(_mm_loadu_ps(m + 12), _mm_setr_ps(translation.x(), translation.y(), translation.z(), 0));
+    for(size_t i = 0; i < count; ++i, positions += stride)
+    {
+        float* p = reinterpret_cast<float*>(positions);
+        const __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(col0, _mm_set1_ps(p[0])), _mm_mul_ps(col1, _mm_set1_ps(p[1]))), _mm_add_ps(_mm_mul_ps(col2, _mm_set1_ps(p[2])), col3));
+        _mm_storel_pi(reinterpret_cast<__m64*>(p), r);
+        _mm_store_ss(p + 2, _mm_movehl_ps(r, r));
+    }
+#else
+    const float tx = m[12] + translation.x(), ty = m[13] + translation.y(), tz = m[14] + translation.z();
+    for(size_t i = 0; i < count; ++i, positions += stride)
+    {
+        float* p = reinterpret_cast<float*>(positions);
+        const float x = p[0], y = p[1], z = p[2];
+        p[0] = m[0] * x + m[4] * y + m[8] * z + tx;
+        p[1] = m[1] * x + m[5] * y + m[9] * z + ty;
+        p[2] = m[2] * x + m[6] * y + m[10] * z + tz;
+    }
+#endif
+}
+
 M3 MatrixUtil::transpose(const M3& matrix)
 {
     return glm::transpose(glm::make_mat3(matrix.value()));
@@ -38,6 +38,9 @@ public:
     static V3 transform(const M4& matrix, const V3& pos);
     static V3 transform(const M4& matrix, const V3& pos, const V3& org);
 
+//  Transforms "count" positions laid out every "stride" bytes in place, as affine points (w = 1), then adds "translation".
+    static void transformPositions(const M4& affine, const V3& translation, uint8_t* positions, size_t count, size_t stride);
+
     static M3 transpose(const M3& matrix);
     static M4 transpose(const M4& matrix);
 
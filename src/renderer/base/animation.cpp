@@ -1,38 +1,97 @@
 #include "renderer/base/animation.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 #include "node.h"
-#include "core/util/integer_type.h"
 #include "core/util/math.h"
+#include "core/util/numeric_type.h"
 
 #include "graphics/base/mat.h"
+#include "graphics/util/matrix_util.h"
 
 namespace ark {
 
+struct Animation::Stub {
+    Stub(const float tps, const float duration, const uint32_t durationInTicks, Vector<AnimationFrame> animationFrames, Vector<NodeTracks> nodeTracks)
+        : _tps(tps), _duration(duration), _duration_in_ticks(durationInTicks), _animation_frames(std::move(animationFrames)), _node_tracks(std::move(nodeTracks))
+    {
+    }
+
+    void sample(const float tick, AnimationFrame& frame) const
+    {
+        if(_node_tracks.empty())
+        {
+            frame = _animation_frames.at(Math::floorMod<int32_t>(static_cast<int32_t>(tick), _duration_in_ticks));
+            return;
+        }
+
+        const float time = tick / _tps;
+        const float looped = _duration > 0 ? time - std::floor(time / _duration) * _duration : 0;
+        frame.resize(_node_tracks.size());
+        for(size_t i = 0; i < _node_tracks.size(); ++i)
+            frame[i] = _node_tracks[i].sample(looped);
+    }
+
+    float _tps;
+    float _duration;
+    uint32_t _duration_in_ticks;
+
+    Vector<AnimationFrame> _animation_frames;
+    Vector<NodeTracks> _node_tracks;
+};
+
 namespace {
 
+uint16_t quantize(const float value)
+{
+    return static_cast<uint16_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+
+//  One per animated instance, shared by the Mat4s of its nodes. All nodes are sampled at once, once per tick, into a frame buffer that is reused from tick to tick.
 struct AnimationSession {
 
-    AnimationSession(sp<Integer> tick, const uint32_t durationInTicks, sp<Vector<AnimationFrame>> animationFrames)
-        : _tick(std::move(tick)), _duration_in_ticks(durationInTicks), _animation_frames(std::move(animationFrames))
+    AnimationSession(sp<Numeric> tick, Animation animation)
+        : _tick(std::move(tick)), _animation(std::move(animation)), _sampled(false), _sampled_tick(0)
     {
-        ASSERT(_duration_in_ticks);
+        ASSERT(_animation.ticks() || _animation.hasLocalFrames());
     }
 
-    bool update(const uint32_t timestamp) const
+//  Frames are sampled here rather than in "currentFrame", so snapshots only read them.
+    bool update(const uint32_t timestamp)
     {
-        return _tick->update(timestamp);
+        const bool dirty = _tick->update(timestamp);
+        if(dirty || !_sampled)
+            ensureFrame();
+        return dirty;
     }
 
-    const AnimationFrame& currentFrame() const
+    const AnimationFrame& currentFrame()
     {
-        const int32_t frame = Math::floorMod<int32_t>(_tick->val(), _duration_in_ticks);
-        return _animation_frames->at(frame);
+        if(!_sampled)
+            ensureFrame();
+        return _frame;
     }
 
 private:
-    sp<Integer> _tick;
-    uint32_t _duration_in_ticks;
-    sp<Vector<AnimationFrame>> _animation_frames;
+    void ensureFrame()
+    {
+        if(const float tick = _tick->val(); !_sampled || _sampled_tick != tick)
+        {
+            _animation.sample(tick, _frame);
+            _sampled = true;
+            _sampled_tick = tick;
+        }
+    }
+
+private:
+    sp<Numeric> _tick;
+    Animation _animation;
+
+    bool _sampled;
+    float _sampled_tick;
+    AnimationFrame _frame;
 };
 
 class LocalMatrix final : public Mat4 {
@@ -70,8 +129,9 @@ public:
     M4 val() override
     {
         M4 transform;
+        const AnimationFrame& frame = _session->currentFrame();
         for(const auto& [k, v] : _transform_path)
-            transform = (k >= 0 ? v * _session->currentFrame().at(k) : v) * transform;
+            transform = (k >= 0 ? v * frame.at(k) : v) * transform;
         return transform;
     }
 
@@ -82,8 +142,97 @@ private:
 
 }
 
+Animation::Track::Track(const Interpolation interpolation, const Vector<float>& times, const Vector<V4>& values, const bool isRotation)
+    : _interpolation(interpolation), _is_rotation(isRotation), _component_count(isRotation ? 4 : 3), _time_begin(0), _time_scale(0)
+{
+    CHECK(!times.empty() && times.size() <= values.size(), "Illegal keyframes, %d key times with %d values", times.size(), values.size());
+    _time_begin = times.front();
+    const float timeRange = times.back() - times.front();
+    _time_scale = timeRange / 65535.0f;
+    _times.reserve(times.size());
+    for(const float i : times)
+        _times.push_back(timeRange > 0 ? quantize((i - _time_begin) / timeRange) : 0);
+
+    float valueMin[4] = {-1.0f, -1.0f, -1.0f, -1.0f};
+    float valueMax[4] = {1.0f, 1.0f, 1.0f, 1.0f};
+    if(!isRotation)
+        for(uint32_t i = 0; i < _component_count; ++i)
+        {
+            valueMin[i] = std::numeric_limits<float>::max();
+            valueMax[i] = std::numeric_limits<float>::lowest();
+            for(size_t j = 0; j < times.size(); ++j)
+            {
+                const float value = i == 0 ? values[j].x() : (i == 1 ? values[j].y() : values[j].z());
+                valueMin[i] = std::min(valueMin[i], value);
+                valueMax[i] = std::max(valueMax[i], value);
+            }
+        }
+
+    _value_offset = V4(valueMin[0], valueMin[1], valueMin[2], valueMin[3]);
+    _value_scale = V4((valueMax[0] - valueMin[0]) / 65535.0f, (valueMax[1] - valueMin[1]) / 65535.0f, (valueMax[2] - valueMin[2]) / 65535.0f, (valueMax[3] - valueMin[3]) / 65535.0f);
+    _values.reserve(times.size() * _component_count);
+    for(size_t i = 0; i < times.size(); ++i)
+    {
+        const float value[4] = {values[i].x(), values[i].y(), values[i].z(), values[i].w()};
+        for(uint32_t j = 0; j < _component_count; ++j)
+            _values.push_back(valueMax[j] > valueMin[j] ? quantize((value[j] - valueMin[j]) / (valueMax[j] - valueMin[j])) : 0);
+    }
+}
+
+V4 Animation::Track::sample(const float time) const
+{
+    const size_t keyCount = _times.size();
+    const float t = _time_scale > 0 ? (time - _time_begin) / _time_scale : 0;
+    if(keyCount == 1 || t <= _times.front())
+        return dequantize(0);
+    if(t >= _times.back())
+        return dequantize(keyCount - 1);
+
+    const size_t next = std::upper_bound(_times.begin(), _times.end(), t, [](const float value, const uint16_t key) {
+        return value < static_cast<float>(key);
+    }) - _times.begin();
+    const size_t prev = next - 1;
+    if(_interpolation == INTERPOLATION_STEP)
+        return dequantize(prev);
+
+    const float u = (t - _times[prev]) / static_cast<float>(_times[next] - _times[prev]);
+    if(_is_rotation)
+        return Math::slerp(dequantize(prev), dequantize(next), u);
+    return dequantize(prev) * (1.0f - u) + dequantize(next) * u;
+}
+
+size_t Animation::Track::keyCount() const
+{
+    return _times.size();
+}
+
+size_t Animation::Track::memoryUsage() const
+{
+    return sizeof(Track) + (_times.capacity() + _values.capacity()) * sizeof(uint16_t);
+}
+
+V4 Animation::Track::dequantize(const size_t index) const
+{
+    const uint16_t* value = _values.data() + index * _component_count;
+    if(_is_rotation)
+        return Math::normalize(_value_offset + V4(value[0], value[1], value[2], value[3]) * _value_scale);
+    return _value_offset + V4(value[0], value[1], value[2], 0) * _value_scale;
+}
+
+M4 Animation::NodeTracks::sample(const float time) const
+{
+    return _local_inversed * MatrixUtil::scale(MatrixUtil::rotate(MatrixUtil::translate({}, _translation.sample(time)), _rotation.sample(time)), _scale.sample(time));
+}
+
 Animation::Animation(String name, const uint32_t durationInTicks, Table<String, uint32_t> nodes, Vector<AnimationFrame> animationFrames)
-    : _name(std::move(name)), _tps(24.0f), _duration(static_cast<float>(durationInTicks) / _tps), _duration_in_ticks(durationInTicks), _nodes(sp<Table<String, uint32_t>>::make(std::move(nodes))), _animation_frames(sp<Vector<AnimationFrame>>::make(std::move(animationFrames)))
+    : _name(std::move(name)), _tps(24.0f), _duration(static_cast<float>(durationInTicks) / _tps), _duration_in_ticks(durationInTicks), _nodes(sp<Table<String, uint32_t>>::make(std::move(nodes))),
+      _stub(sp<Stub>::make(_tps, _duration, _duration_in_ticks, std::move(animationFrames), Vector<NodeTracks>()))
+{
+}
+
+Animation::Animation(String name, const float tps, const float duration, Table<String, uint32_t> nodes, Vector<NodeTracks> nodeTracks)
+    : _name(std::move(name)), _tps(tps), _duration(duration), _duration_in_ticks(static_cast<uint32_t>(duration * tps)), _nodes(sp<Table<String, uint32_t>>::make(std::move(nodes))),
+      _stub(sp<Stub>::make(_tps, _duration, _duration_in_ticks, Vector<AnimationFrame>(), std::move(nodeTracks)))
 {
 }
 
@@ -108,21 +257,21 @@ uint32_t Animation::ticks() const
 }
 
 Vector<std::pair<String, sp<Mat4>>> Animation::getLocalTransforms(sp<Integer> tick) const
+{
+    return getLocalTransforms(sp<Numeric>(NumericType::create(std::move(tick))));
+}
+
+Vector<std::pair<String, sp<Mat4>>> Animation::getLocalTransforms(sp<Numeric> tick) const
 {
     Vector<std::pair<String, sp<Mat4>>> nodeTransforms;
 
-    sp<AnimationSession> session = sp<AnimationSession>::make(std::move(tick), _duration_in_ticks, _animation_frames);
+    sp<AnimationSession> session = sp<AnimationSession>::make(std::move(tick), *this);
     for(const auto& [name, nodeIdx] : *_nodes)
         nodeTransforms.emplace_back(name, sp<Mat4>::make<LocalMatrix>(session, nodeIdx));
 
     return nodeTransforms;
 }
 
-Vector<std::pair<String, sp<Mat4>>> Animation::getLocalTransforms(sp<Numeric> tick) const
-{
-    return getLocalTransforms(IntegerType::create(std::move(tick)));
-}
-
 sp<Mat4> Animation::getGlobalTransform(const Node& node, sp<Integer> tick) const
 {
     Vector<std::pair<int32_t, M4>> transformPath;
@@ -142,8 +291,38 @@ sp<Mat4> Animation::getGlobalTransform(const Node& node, sp<Integer> tick) const
         pNode = pNode->parentNode().get();
     } while(pNode);
 
-    sp<AnimationSession> session = sp<AnimationSession>::make(std::move(tick), _duration_in_ticks, _animation_frames);
+    sp<AnimationSession> session = sp<AnimationSession>::make(NumericType::create(std::move(tick)), *this);
     return sp<Mat4>::make<GlobalMatrix>(std::move(session), std::move(transformPath));
 }
 
+const Table<String, uint32_t>& Animation::nodes() const
+{
+    return *_nodes;
+}
+
+bool Animation::hasLocalFrames() const
+{
+    return !_stub->_node_tracks.empty();
+}
+
+void Animation::sample(const float tick, AnimationFrame& frame) const
+{
+    _stub->sample(tick, frame);
+}
+
+const M4& Animation::inverseBindMatrix(const uint32_t nodeIndex) const
+{
+    return _stub->_node_tracks.empty() ? M4::identity() : _stub->_node_tracks.at(nodeIndex)._inverse_bind_matrix;
+}
+
+size_t Animation::memoryUsage() const
+{
+    size_t usage = 0;
+    for(const AnimationFrame& i : _stub->_animation_frames)
+        usage += i.capacity() * sizeof(M4);
+    for(const NodeTracks& i : _stub->_node_tracks)
+        usage += sizeof(M4) + i._translation.memoryUsage() + i._rotation.memoryUsage() + i._scale.memoryUsage();
+    return usage;
+}
+
 }
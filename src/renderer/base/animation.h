@@ -7,6 +7,8 @@
 #include "core/types/shared_ptr.h"
 
 #include "graphics/forwarding.h"
+#include "graphics/base/mat.h"
+#include "graphics/base/v4.h"
 
 #include "renderer/forwarding.h"
 
@@ -16,7 +18,50 @@ typedef Vector<M4> AnimationFrame;
 
 class ARK_API Animation {
 public:
+    enum Interpolation {
+        INTERPOLATION_LINEAR,
+        INTERPOLATION_STEP
+    };
+
+//  Keyframes of one translation, rotation or scale channel. Key times and values are quantized to 16 bits over their ranges.
+    class ARK_API Track {
+    public:
+        Track(Interpolation interpolation, const Vector<float>& times, const Vector<V4>& values, bool isRotation);
+
+        V4 sample(float time) const;
+
+        size_t keyCount() const;
+        size_t memoryUsage() const;
+
+    private:
+        V4 dequantize(size_t index) const;
+
+    private:
+        Interpolation _interpolation;
+        bool _is_rotation;
+        uint32_t _component_count;
+        float _time_begin;
+        float _time_scale;
+        V4 _value_offset;
+        V4 _value_scale;
+        Vector<uint16_t> _times;
+        Vector<uint16_t> _values;
+    };
+
+    struct NodeTracks {
+        M4 sample(float time) const;
+
+        M4 _local_inversed;
+        Track _translation;
+        Track _rotation;
+        Track _scale;
+//  Identity unless the node is a skin joint.
+        M4 _inverse_bind_matrix;
+    };
+
     Animation(String name, uint32_t durationInTicks, Table<String, uint32_t> nodes, Vector<AnimationFrame> animationFrames);
+//  Keyframe animation sampled with interpolation at fractional ticks, "duration" is in seconds.
+    Animation(String name, float tps, float duration, Table<String, uint32_t> nodes, Vector<NodeTracks> nodeTracks);
 
 //  [[script::bindings::property]]
     const String& name() const;
@@ -35,6 +80,22 @@ public:
 //  [[script::bindings::auto]]
     sp<Mat4> getGlobalTransform(const Node& node, sp<Integer> tick) const;
 
+//  Animated node names and their indices in sampled frames.
+    const Table<String, uint32_t>& nodes() const;
+//  Keyframe tracks are sampled into node local transforms, baked frames are model space transforms already.
+    bool hasLocalFrames() const;
+
+//  Samples transforms of all animated nodes at once, indexed as in "nodes".
+    void sample(float tick, AnimationFrame& frame) const;
+//  Inverse bind matrix of the animated node at "nodeIndex". Baked frames have theirs applied already, so it's identity for them.
+    const M4& inverseBindMatrix(uint32_t nodeIndex) const;
+
+//  Bytes taken by the frames or keyframe tracks of this Animation.
+    size_t memoryUsage() const;
+
+private:
+    struct Stub;
+
 private:
     String _name;
     float _tps;
@@ -42,7 +103,7 @@ private:
     uint32_t _duration_in_ticks;
 
     sp<Table<String, uint32_t>> _nodes;
-    sp<Vector<AnimationFrame>> _animation_frames;
+    sp<Stub> _stub;
 };
 
 }
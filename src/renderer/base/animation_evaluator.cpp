@@ -0,0 +1,192 @@
+#include "renderer/base/animation_evaluator.h"
+
+#include <mutex>
+
+#include "core/ark.h"
+#include "core/inf/executor.h"
+#include "core/inf/uploader.h"
+#include "core/inf/variable.h"
+#include "core/inf/writable.h"
+#include "core/util/parallel_util.h"
+
+#include "renderer/base/animation.h"
+#include "renderer/base/node.h"
+
+#include "app/base/application_context.h"
+
+namespace ark {
+
+//  Nodes of a hierarchy flattened so that parents always come before their children.
+struct AnimationEvaluator::Skeleton {
+    struct Joint {
+        int32_t _parent;
+        int32_t _frame_index;
+        M4 _local_matrix;
+        M4 _inverse_bind_matrix;
+    };
+
+    Skeleton(const Animation& animation, sp<Node> rootNode)
+        : _root_node(std::move(rootNode)), _palette_size(animation.nodes().size())
+    {
+        if(animation.hasLocalFrames())
+            flatten(animation, _root_node, -1);
+        else
+            for(uint32_t i = 0; i < _palette_size; ++i)
+                _joints.push_back({-1, static_cast<int32_t>(i), M4::identity(), M4::identity()});
+    }
+
+    void flatten(const Animation& animation, const Node& node, const int32_t parent)
+    {
+        const auto iter = animation.nodes().find(node.name());
+        const int32_t jointIndex = static_cast<int32_t>(_joints.size());
+        const int32_t frameIndex = iter != animation.nodes().end() ? static_cast<int32_t>(iter->second) : -1;
+        _joints.push_back({parent, frameIndex, node.localMatrix(), frameIndex >= 0 ? animation.inverseBindMatrix(frameIndex) : M4::identity()});
+        for(const sp<Node>& i : node.childNodes())
+            flatten(animation, i, jointIndex);
+    }
+
+    sp<Node> _root_node;
+    size_t _palette_size;
+    Vector<Joint> _joints;
+};
+
+struct AnimationEvaluator::Instance {
+    Instance(sp<Animation> animation, sp<Skeleton> skeleton, sp<Numeric> tick)
+        : _animation(std::move(animation)), _skeleton(std::move(skeleton)), _tick(std::move(tick)), _palette(_skeleton->_palette_size, M4::identity()), _globals(_skeleton->_joints.size()),
+          _dirty(true), _pending(true)
+    {
+    }
+
+    void evaluate()
+    {
+        _animation->sample(_tick->val(), _frame);
+        for(size_t i = 0; i < _skeleton->_joints.size(); ++i)
+        {
+            const Skeleton::Joint& joint = _skeleton->_joints[i];
+            const M4 local = joint._frame_index >= 0 ? joint._local_matrix * _frame[joint._frame_index] : joint._local_matrix;
+            _globals[i] = joint._parent >= 0 ? _globals[joint._parent] * local : local;
+            if(joint._frame_index >= 0)
+                _palette[joint._frame_index] = _globals[i] * joint._inverse_bind_matrix;
+        }
+    }
+
+    sp<Animation> _animation;
+    sp<Skeleton> _skeleton;
+    sp<Numeric> _tick;
+
+    Vector<M4> _palette;
+    Vector<M4> _globals;
+    AnimationFrame _frame;
+    bool _dirty;
+//  Evaluated on creation, but not uploaded yet.
+    bool _pending;
+};
+
+struct AnimationEvaluator::Stub {
+    Stub(sp<Executor> executor, const uint32_t chunkSize)
+        : _executor(std::move(executor)), _chunk_size(chunkSize), _tick(0)
+    {
+    }
+
+//  Variables are updated here serially, only the sampling and the hierarchy walks of the dirty instances go to the thread pool.
+//  Palettes are updated from wherever their uploaders get updated, compose threads included, so the first caller of a tick evaluates it under the lock and the others wait for it.
+    void update(const uint32_t tick)
+    {
+        const std::lock_guard<std::mutex> guard(_mutex);
+        if(_tick == tick)
+            return;
+
+        _tick = tick;
+        _dirty_instances.clear();
+        for(auto iter = _instances.begin(); iter != _instances.end(); )
+        {
+            if(const sp<Instance> instance = iter->lock())
+            {
+                const bool dirty = instance->_tick->update(tick);
+                instance->_dirty = dirty || instance->_pending;
+                instance->_pending = false;
+                if(dirty)
+                    _dirty_instances.push_back(instance.get());
+                ++iter;
+            }
+            else
+                iter = _instances.erase(iter);
+        }
+
+        const auto evaluate = [this](const size_t begin, const size_t end) {
+            for(size_t i = begin; i < end; ++i)
+                _dirty_instances[i]->evaluate();
+        };
+        if(_executor && _dirty_instances.size() > _chunk_size)
+            ParallelUtil::forEachChunk(*_executor, _dirty_instances.size(), _chunk_size, evaluate);
+        else if(!_dirty_instances.empty())
+            evaluate(0, _dirty_instances.size());
+    }
+
+    sp<Skeleton> ensureSkeleton(const Animation& animation, sp<Node> rootNode)
+    {
+        const std::pair<const Animation*, const Node*> key(&animation, rootNode.get());
+        if(const auto iter = _skeletons.find(key); iter != _skeletons.end())
+            if(sp<Skeleton> skeleton = iter->second.lock())
+                return skeleton;
+
+        std::erase_if(_skeletons, [](const auto& item) {
+            return item.second.expired();
+        });
+        sp<Skeleton> skeleton = sp<Skeleton>::make(animation, std::move(rootNode));
+        _skeletons[key] = skeleton;
+        return skeleton;
+    }
+
+    sp<Executor> _executor;
+    size_t _chunk_size;
+
+    std::mutex _mutex;
+    uint32_t _tick;
+
+    Vector<WeakPtr<Instance>> _instances;
+    Vector<Instance*> _dirty_instances;
+    Map<std::pair<const Animation*, const Node*>, WeakPtr<Skeleton>> _skeletons;
+};
+
+class AnimationEvaluator::PaletteUploader final : public Uploader {
+public:
+    PaletteUploader(sp<Stub> stub, sp<Instance> instance)
+        : Uploader(instance->_palette.size() * sizeof(M4)), _stub(std::move(stub)), _instance(std::move(instance)) {
+    }
+
+    void upload(Writable& buf) override {
+        buf.write(_instance->_palette.data(), static_cast<uint32_t>(_size), 0);
+    }
+
+    bool update(const uint32_t tick) override {
+        _stub->update(tick);
+        return _instance->_dirty;
+    }
+
+private:
+    sp<Stub> _stub;
+    sp<Instance> _instance;
+};
+
+AnimationEvaluator::AnimationEvaluator(const uint32_t chunkSize)
+    : AnimationEvaluator(nullptr, chunkSize)
+{
+}
+
+AnimationEvaluator::AnimationEvaluator(sp<Executor> executor, const uint32_t chunkSize)
+    : _stub(sp<Stub>::make(executor || !Ark::instance().applicationContext() ? std::move(executor) : Ark::instance().applicationContext()->threadPoolExecutor(), std::max<uint32_t>(chunkSize, 1)))
+{
+}
+
+sp<Uploader> AnimationEvaluator::makePalette(sp<Animation> animation, sp<Node> rootNode, sp<Numeric> tick)
+{
+    const std::lock_guard<std::mutex> guard(_stub->_mutex);
+    sp<Skeleton> skeleton = _stub->ensureSkeleton(animation, std::move(rootNode));
+    sp<Instance> instance = sp<Instance>::make(std::move(animation), std::move(skeleton), std::move(tick));
+    instance->evaluate();
+    _stub->_instances.push_back(instance);
+    return sp<Uploader>::make<PaletteUploader>(_stub, std::move(instance));
+}
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "core/forwarding.h"
+#include "core/base/api.h"
+#include "core/types/shared_ptr.h"
+#include "core/types/weak_ptr.h"
+
+#include "graphics/forwarding.h"
+#include "graphics/base/mat.h"
+
+#include "renderer/forwarding.h"
+
+namespace ark {
+
+//  Evaluates skinning palettes of animated instances once per tick. Every node matrix of an instance is computed in one topological pass into its palette,
+//  and the instances are spread across the thread pool in chunks of "chunkSize".
+class ARK_API AnimationEvaluator {
+public:
+//  [[script::bindings::auto]]
+    AnimationEvaluator(uint32_t chunkSize = 4);
+    AnimationEvaluator(sp<Executor> executor, uint32_t chunkSize);
+
+//  Palette of "animation" played on the node hierarchy of "rootNode" at "tick", one M4 per animated node in the order of Animation::nodes(), so Mesh::BoneInfo ids index it.
+//  [[script::bindings::auto]]
+    sp<Uploader> makePalette(sp<Animation> animation, sp<Node> rootNode, sp<Numeric> tick);
+
+private:
+    struct Skeleton;
+    struct Instance;
+    struct Stub;
+    class PaletteUploader;
+
+private:
+    sp<Stub> _stub;
+};
+
+}
@@ -22,6 +22,7 @@ VertexWriter DrawingBuffer::makeVertexWriter(const RenderRequest& renderRequest,
 {
     const size_t size = length * _vertices._stride;
     ByteArray::View content = renderRequest.allocator().sbrkSpan(size);
+    memset(content.buf(), 0, size);
     _vertices.addStrip(offset * _vertices._stride, content);
     return VertexWriter(_pipeline_descriptor->vertexDescriptor(), !_is_instanced, size, _vertices._stride, content.buf());
 }
@@ -31,6 +32,7 @@ VertexWriter DrawingBuffer::makeDividedVertexWriter(const RenderRequest& renderR
     Buffer::SnapshotFactory& builder = getDividedBufferBuilder(divisor);
     const size_t size = length * builder._stride;
     ByteArray::View content = renderRequest.allocator().sbrkSpan(size);
+    memset(content.buf(), 0, size);
     builder.addStrip(offset * builder._stride, content);
     return VertexWriter(_pipeline_descriptor->vertexDescriptor(), !_is_instanced, size, builder._stride, content.buf());
 }
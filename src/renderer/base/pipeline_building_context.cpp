@@ -1,7 +1,6 @@
 #include "renderer/base/pipeline_building_context.h"
 
 #include <ranges>
-#include <regex>
 
 #include "core/inf/uploader.h"
 #include "core/util/strings.h"
@@ -1,5 +1,6 @@
 #include "renderer/base/pipeline_layout.h"
 
+#include <atomic>
 #include <ranges>
 
 #include "core/base/allocator.h"
@@ -14,6 +15,8 @@ namespace ark {
 
 namespace {
 
+std::atomic<uint32_t> _pipeline_layout_id_counter = 0;
+
 uint32_t getAttributeSize(const Attribute::Usage usage)
 {
     switch(usage)
@@ -104,7 +107,7 @@ void PipelineLayout::VertexDescriptor::initialize(const PipelineLayout& pipeline
 }
 
 PipelineLayout::PipelineLayout()
-    : _vertex_layouts{{0, VertexLayout()}}, _color_attachment_count(0)
+    : _id(++ _pipeline_layout_id_counter), _vertex_layouts{{0, VertexLayout()}}, _color_attachment_count(0)
 {
 }
 
@@ -158,6 +161,11 @@ const Vector<std::pair<uint32_t, PipelineLayout::VertexLayout>>& PipelineLayout:
     return _vertex_layouts;
 }
 
+uint32_t PipelineLayout::id() const
+{
+    return _id;
+}
+
 const HashMap<String, PipelineLayout::VaryingSlot>& PipelineLayout::varyingSlots() const
 {
     return _varying_slots;
@@ -119,6 +119,9 @@ public:
 
     const VertexDescriptor& vertexDescriptor() const;
 
+    // Unique for the lifetime of the process, so caches keyed by it never see a reused address.
+    uint32_t id() const;
+
     // Attribute name -> resolved (divisor, offset), precomputed in initialize(). Used by Varyings.
     const HashMap<String, VaryingSlot>& varyingSlots() const;
 
@@ -140,6 +143,8 @@ public:
     void initializeSSBO(const PipelineBuildingContext& buildingContext);
 
 private:
+    uint32_t _id;
+
     Vector<sp<UBO>> _ubos;
     Vector<SSBO> _ssbos;
 
@@ -1,5 +1,6 @@
 #include "renderer/base/render_controller.h"
 
+#include "core/ark.h"
 #include "core/base/future.h"
 #include "core/inf/runnable.h"
 #include "core/inf/writable.h"
@@ -19,6 +20,8 @@
 #include "renderer/inf/renderer_factory.h"
 #include "renderer/util/render_util.h"
 
+#include "app/base/application_manifest.h"
+
 #include "platform/platform.h"
 #include "renderer/inf/pipeline_factory.h"
 
@@ -188,7 +191,8 @@ Buffer::Snapshot RenderController::PrimitiveIndexBuffer::snapshot(RenderControll
 }
 
 RenderController::RenderController(const sp<RenderBackend>& renderBackend, const sp<BitmapLoaderBundle>& bitmapLoader, const sp<BitmapLoaderBundle>& bitmapBoundsLoader)
-    : _render_backend(renderBackend), _recycler(sp<Recycler>::make()), _bitmap_loader(bitmapLoader), _bitmap_bounds_loader(bitmapBoundsLoader), _gba(*this), _tick(0)
+    : _render_backend(renderBackend), _recycler(sp<Recycler>::make()), _bitmap_loader(bitmapLoader), _bitmap_bounds_loader(bitmapBoundsLoader),
+      _streaming_budget(Ark::instance().manifest()->renderer()._texture_upload_budget), _gba(*this), _tick(0)
 {
 }
 
@@ -221,6 +225,25 @@ void RenderController::prepare(GraphicsContext& graphicsContext, LFQueue<Uploadi
         }
 }
 
+void RenderController::prepareStreaming(GraphicsContext& graphicsContext)
+{
+    size_t uploadedSize = 0;
+    while(_streaming_budget == 0 || uploadedSize < _streaming_budget)
+    {
+        Optional<StreamingRenderResource> optFront = _streaming_resources.pop();
+        if(!optFront)
+            break;
+
+        if(const StreamingRenderResource front = std::move(optFront.value()); !front._resource.isCancelled())
+        {
+            front._resource.upload(graphicsContext);
+            uploadedSize += front._byte_size;
+            if(front._future)
+                front._future->notify();
+        }
+    }
+}
+
 void RenderController::onDrawFrame(GraphicsContext& graphicsContext)
 {
     DPROFILER_TRACE("PreFrameUpdate");
@@ -229,6 +252,7 @@ void RenderController::onDrawFrame(GraphicsContext& graphicsContext)
     _recycler->doRecycling();
 
     prepare(graphicsContext, _uploading_resources);
+    prepareStreaming(graphicsContext);
     _on_every_frame.foreach(graphicsContext, false, true);
 
     if(const uint32_t tick = graphicsContext.tick() % 300; tick == 0)
@@ -250,6 +274,11 @@ void RenderController::upload(sp<Resource> resource, const enums::UploadStrategy
         _uploading_resources.push(UploadingRenderResource(RenderResource(std::move(resource), std::move(future)), strategy, priority));
 }
 
+void RenderController::uploadStreaming(sp<Resource> resource, const size_t byteSize, sp<Future> future)
+{
+    _streaming_resources.push(StreamingRenderResource(RenderResource(std::move(resource), future), byteSize, future));
+}
+
 void RenderController::uploadBuffer(const Buffer& buffer, sp<Uploader> uploader, const enums::UploadStrategy strategy, sp<Future> future, const enums::UploadPriority priority)
 {
     ASSERT(uploader);
@@ -443,6 +472,11 @@ RenderController::UploadingRenderResource::UploadingRenderResource(RenderResourc
 {
 }
 
+RenderController::StreamingRenderResource::StreamingRenderResource(RenderResource resource, const size_t byteSize, sp<Future> future)
+    : _resource(std::move(resource)), _byte_size(byteSize), _future(std::move(future))
+{
+}
+
 void RenderController::RenderResourceList::append(enums::UploadPriority priority, RenderResource ur)
 {
     _resources[priority].push_back(std::move(ur));
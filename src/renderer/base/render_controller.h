@@ -78,6 +78,9 @@ public:
     void onDrawFrame(GraphicsContext& graphicsContext);
 
     void upload(sp<Resource> resource, enums::UploadStrategy strategy, sp<Updatable> updatable = nullptr, sp<Future> future = nullptr, enums::UploadPriority priority = enums::UPLOAD_PRIORITY_NORMAL);
+//  [[ark::threadsafe]]
+//  Uploads a resource whose data got prepared off the render thread. Uploads are spread over frames within "texture-upload-budget" bytes per frame, the future gets notified once it's done.
+    void uploadStreaming(sp<Resource> resource, size_t byteSize, sp<Future> future = nullptr);
 
 //  [[script::bindings::auto]]
     void uploadBuffer(const Buffer& buffer, sp<Uploader> input, enums::UploadStrategy strategy, sp<Future> future = nullptr, enums::UploadPriority priority = enums::UPLOAD_PRIORITY_NORMAL);
@@ -148,6 +151,16 @@ private:
         enums::UploadPriority _priority;
     };
 
+    struct StreamingRenderResource {
+        StreamingRenderResource() = default;
+        StreamingRenderResource(RenderResource resource, size_t byteSize, sp<Future> future);
+        DEFAULT_COPY_AND_ASSIGN_NOEXCEPT(StreamingRenderResource);
+
+        RenderResource _resource;
+        size_t _byte_size;
+        sp<Future> _future;
+    };
+
     class RenderResourceList {
     public:
         void append(enums::UploadPriority priority, RenderResource ur);
@@ -160,6 +173,7 @@ private:
 
 private:
     void prepare(GraphicsContext& graphicsContext, LFQueue<UploadingRenderResource>& items);
+    void prepareStreaming(GraphicsContext& graphicsContext);
 
 private:
     sp<RenderBackend> _render_backend;
@@ -168,6 +182,8 @@ private:
     sp<BitmapLoaderBundle> _bitmap_bounds_loader;
 
     LFQueue<UploadingRenderResource> _uploading_resources;
+    LFQueue<StreamingRenderResource> _streaming_resources;
+    size_t _streaming_budget;
 
     RenderResourceList _on_surface_ready;
     RenderResourceList _on_every_frame;
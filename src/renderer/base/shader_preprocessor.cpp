@@ -1,6 +1,6 @@
 #include "renderer/base/shader_preprocessor.h"
 
-#include <regex>
+#include <algorithm>
 
 #include "core/base/bit_set.h"
 #include "core/base/enum.h"
@@ -14,26 +14,12 @@
 #include "renderer/base/render_controller.h"
 #include "renderer/util/render_util.h"
 
-#define ARRAY_PATTERN           "(?:\\[\\s*(\\d+)\\s*\\])?"
-#define STD_TYPE_PATTERN        "int|uint8|float|[bi]?vec[234]|mat3|mat4"
-#define ATTRIBUTE_PATTERN       "\\s+(" STD_TYPE_PATTERN ")\\s+" "(?:a_|v_)(\\w+)" ARRAY_PATTERN ";"
-#define UNIFORM_PATTERN         "(\\w+)\\s+" "(\\w+)" ARRAY_PATTERN ";"
-#define LAYOUT_PATTERN          R"--(layout\((?:packed|shared|std140|std430|binding\s*=\s*(\d+)|set\s*=\s*(\d+)|[rgba]+\d+[uif]*|location=\d+|[\s,])+\)\s+)--"
-#define ACCESSIBILITY_PATTERN   "(?:(?:read|write)only\\s+)?"
-
 #define INDENT_STR "    "
 
 namespace ark {
 
 namespace {
 
-const std::regex REGEX_INCLUDE_PATTERN(R"(#include\s*[<"]([^>"]+)[>"])");
-const std::regex REGEX_STRUCT_PATTERN(R"(struct\s+(\w+)\s*\{([^}]+)\}\s*;)");
-const std::regex REGEX_IN_PATTERN("(?:attribute|varying|in)" ATTRIBUTE_PATTERN);
-const std::regex REGEX_UNIFORM_PATTERN("(?:" LAYOUT_PATTERN ")?uniform\\s+" ACCESSIBILITY_PATTERN UNIFORM_PATTERN);
-const std::regex REGEX_SSBO_PATTERN(LAYOUT_PATTERN ACCESSIBILITY_PATTERN "buffer\\s+(\\w+)");
-const std::regex REGEX_LOCAL_SIZE_PATTERN(R"--(layout\s*\(((?:local_size_[xyz]\s*=\s*\d+\s*,?\s*)+)\)\s+in\s*;)--");
-
 #ifndef ANDROID
 constexpr char STAGE_ATTR_PREFIX[enums::SHADER_STAGE_BIT_COUNT + 1][4] = {"a_", "v_", "t_", "e_", "g_", "f_", "c_"};
 #else
@@ -49,10 +35,275 @@ size_t parseFunctionBody(const String& s, String& body)
     return end + 1;
 }
 
-bool sanitizer(const std::smatch& match)
+//  GLSL tokenizer which skips whitespaces and comments. Identifiers and numbers come out as one token, anything else one character at a time.
+class GLSLScanner {
+public:
+    GLSLScanner(const StringView source)
+        : _source(source), _position(0), _token_begin(0) {
+    }
+
+    size_t position() const {
+        return _position;
+    }
+
+    size_t tokenBegin() const {
+        return _token_begin;
+    }
+
+    void seek(const size_t position) {
+        _position = position;
+    }
+
+    StringView next() {
+        skipSpacesAndComments();
+        _token_begin = _position;
+        if(_position >= _source.size())
+            return {};
+
+        if(isWordChar(_source[_position]))
+            while(++ _position < _source.size() && isWordChar(_source[_position]));
+        else
+            ++ _position;
+        return _source.substr(_token_begin, _position - _token_begin);
+    }
+
+    bool accept(const StringView token) {
+        const size_t position = _position;
+        if(next() == token)
+            return true;
+        _position = position;
+        return false;
+    }
+
+//  Raw text from the current position up to "delimiter", the scanner moves past the delimiter.
+    Optional<StringView> until(const char delimiter) {
+        const size_t end = _source.find(delimiter, _position);
+        if(end == StringView::npos)
+            return {};
+        const StringView text = _source.substr(_position, end - _position);
+        _position = end + 1;
+        return text;
+    }
+
+    void skipLine() {
+        const size_t end = _source.find('\n', _position);
+        _position = end == StringView::npos ? _source.size() : end + 1;
+    }
+
+    static bool isIdentifier(const StringView token) {
+        return !token.empty() && !std::isdigit(static_cast<unsigned char>(token[0])) && isWordChar(token[0]);
+    }
+
+    static bool isNumber(const StringView token) {
+        return !token.empty() && std::all_of(token.begin(), token.end(), [](const char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; });
+    }
+
+private:
+    static bool isWordChar(const char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    void skipSpacesAndComments() {
+        while(_position < _source.size())
+            if(std::isspace(static_cast<unsigned char>(_source[_position])))
+                ++ _position;
+            else if(_source.compare(_position, 2, "//") == 0)
+                skipLine();
+            else if(_source.compare(_position, 2, "/*") == 0)
+            {
+                const size_t end = _source.find("*/", _position + 2);
+                _position = end == StringView::npos ? _source.size() : end + 2;
+            }
+            else
+                break;
+    }
+
+private:
+    StringView _source;
+    size_t _position;
+    size_t _token_begin;
+};
+
+typedef ShaderPreprocessor::Statement Statement;
+
+//  #include <path> or #include "path", any other directive is skipped to the end of its line.
+Optional<Statement> scanDirective(GLSLScanner& scanner, const StringView source, const size_t begin)
+{
+    if(scanner.accept("include"))
+    {
+        const StringView quote = scanner.next();
+        if(const Optional<StringView> path = quote == "<" || quote == "\"" ? scanner.until(quote == "<" ? '>' : '"') : Optional<StringView>(); path && !path->empty())
+            return Statement{Statement::STATEMENT_TYPE_INCLUDE, source.substr(begin, scanner.position() - begin), path.value()};
+    }
+    scanner.skipLine();
+    return {};
+}
+
+//  struct Name { body };
+Optional<Statement> scanStruct(GLSLScanner& scanner, const StringView source, const size_t begin)
 {
-    WARN(match.str().c_str());
-    return false;
+    const StringView name = scanner.next();
+    if(!GLSLScanner::isIdentifier(name) || !scanner.accept("{"))
+        return {};
+
+    const Optional<StringView> body = scanner.until('}');
+    if(!body || body->empty() || !scanner.accept(";"))
+        return {};
+    return Statement{Statement::STATEMENT_TYPE_STRUCT, source.substr(begin, scanner.position() - begin), name, body.value()};
+}
+
+bool acceptAccessQualifier(GLSLScanner& scanner, enums::ShaderTypeQualifier& qualifier)
+{
+    if(scanner.accept("readonly"))
+        qualifier.set(enums::SHADER_TYPE_QUALIFIER_READONLY, true);
+    else if(scanner.accept("writeonly"))
+        qualifier.set(enums::SHADER_TYPE_QUALIFIER_WRITEONLY, true);
+    else
+        return false;
+    return true;
+}
+
+//  [layout(...)] [readonly|writeonly] uniform [readonly|writeonly] Type name[[N]];
+//  layout(...) [readonly|writeonly] buffer Name
+//  layout(local_size_x = X, ...) in;
+Optional<Statement> scanQualifiedDeclaration(GLSLScanner& scanner, const StringView source, const size_t begin, StringView token)
+{
+    Statement statement = {};
+    bool hasLayout = false;
+    bool hasLocalSizes = false;
+    if(token == "layout")
+    {
+        if(!scanner.accept("("))
+            return {};
+        const Optional<StringView> layout = scanner.until(')');
+        if(!layout)
+            return {};
+
+        for(const String& i : String(layout.value()).split(','))
+            if(const auto [k, v] = i.cut('='); v)
+            {
+                const String key = k.strip();
+                if(key == "binding")
+                    statement._binding._location = Strings::eval<int32_t>(v.value().strip());
+                else if(key == "set")
+                    statement._binding._set = Strings::eval<int32_t>(v.value().strip());
+                else if(key.startsWith("local_size_") && key.length() == StringView("local_size_x").size())
+                {
+                    const int32_t workGroup = key.at(StringView("local_size_").size()) - 'x';
+                    CHECK(workGroup >= 0 && workGroup < 3, "Unknown layout qualifier \"%s\"", key.c_str());
+                    statement._local_sizes[workGroup] = Strings::eval<int32_t>(v.value().strip());
+                    hasLocalSizes = true;
+                }
+            }
+        hasLayout = true;
+        token = scanner.next();
+    }
+
+    while(token == "readonly" || token == "writeonly")
+    {
+        statement._binding._qualifier.set(token == "readonly" ? enums::SHADER_TYPE_QUALIFIER_READONLY : enums::SHADER_TYPE_QUALIFIER_WRITEONLY, true);
+        token = scanner.next();
+    }
+
+    if(token == "uniform")
+    {
+        while(acceptAccessQualifier(scanner, statement._binding._qualifier));
+        statement._declared_type = scanner.next();
+        statement._name = scanner.next();
+        if(!GLSLScanner::isIdentifier(statement._declared_type) || !GLSLScanner::isIdentifier(statement._name))
+            return {};
+        if(scanner.accept("["))
+        {
+            const StringView length = scanner.next();
+            if(!GLSLScanner::isNumber(length) || !scanner.accept("]"))
+                return {};
+            statement._length = Strings::eval<uint32_t>(length);
+        }
+        if(!scanner.accept(";"))
+            return {};
+        statement._type = Statement::STATEMENT_TYPE_UNIFORM;
+    }
+    else if(token == "buffer" && hasLayout)
+    {
+        statement._name = scanner.next();
+        if(!GLSLScanner::isIdentifier(statement._name))
+            return {};
+        statement._type = Statement::STATEMENT_TYPE_SSBO;
+    }
+    else if(token == "in" && hasLocalSizes && scanner.accept(";"))
+        statement._type = Statement::STATEMENT_TYPE_LOCAL_SIZE;
+    else
+        return {};
+
+    statement._source = source.substr(begin, scanner.position() - begin);
+    return statement;
+}
+
+//  Walks "source" once and calls "visitor" on every statement the preprocessor cares about, in source order.
+void scanStatements(const StringView source, const std::function<void(const Statement&)>& visitor)
+{
+    GLSLScanner scanner(source);
+    for(StringView token = scanner.next(); !token.empty(); token = scanner.next())
+    {
+        const size_t begin = scanner.tokenBegin();
+        const size_t resume = scanner.position();
+        Optional<Statement> statement;
+        if(token == "#")
+            statement = scanDirective(scanner, source, begin);
+        else if(token == "struct")
+            statement = scanStruct(scanner, source, begin);
+        else if(token == "layout" || token == "uniform" || token == "readonly" || token == "writeonly")
+            statement = scanQualifiedDeclaration(scanner, source, begin, token);
+
+        if(statement)
+            visitor(statement.value());
+        else if(token != "#")
+            scanner.seek(resume);
+    }
+}
+
+//  Splits "code" around the statements found in it and appends the pieces to "inserting", returns false if there was nothing to replace.
+bool replaceStatements(const String& code, const std::function<sp<String>(const Statement&)>& replacer, Vector<sp<String>>& inserting, const uint32_t includeDepth)
+{
+    const StringView source = code;
+    size_t unmatched = 0;
+    bool matched = false;
+    scanStatements(source, [&](const Statement& statement) {
+        if(const size_t offset = statement._source.data() - source.data(); offset > unmatched)
+            inserting.push_back(sp<String>::make(source.substr(unmatched, offset - unmatched)));
+        unmatched = statement._source.data() - source.data() + statement._source.size();
+        matched = true;
+
+        sp<String> replacement = replacer(statement);
+        if(replacement && statement._type == Statement::STATEMENT_TYPE_INCLUDE)
+        {
+            CHECK(includeDepth < 16, "Too many nested includes, a cyclic \"#include %s\" maybe?", String(statement._name).c_str());
+            if(replaceStatements(*replacement, replacer, inserting, includeDepth + 1))
+                return;
+        }
+        if(replacement)
+            inserting.push_back(std::move(replacement));
+    });
+
+    if(matched && unmatched < source.size())
+        inserting.push_back(sp<String>::make(source.substr(unmatched)));
+    return matched;
+}
+
+//  Legacy "attribute|varying|in Type a_Name;" declarations, which should be ark_main's parameters instead.
+Optional<StringView> scanNonStandardAttribute(GLSLScanner& scanner, const StringView source, const size_t begin)
+{
+    constexpr StringView stdTypes[] = {"int", "uint8", "float", "vec2", "vec3", "vec4", "bvec2", "bvec3", "bvec4", "ivec2", "ivec3", "ivec4", "mat3", "mat4"};
+    if(const StringView type = scanner.next(); std::find(std::begin(stdTypes), std::end(stdTypes), type) == std::end(stdTypes))
+        return {};
+    if(const StringView name = scanner.next(); !GLSLScanner::isIdentifier(name) || !(name.starts_with("a_") || name.starts_with("v_")) || name.size() < 3)
+        return {};
+    if(scanner.accept("["))
+        if(!GLSLScanner::isNumber(scanner.next()) || !scanner.accept("]"))
+            return {};
+    if(!scanner.accept(";"))
+        return {};
+    return source.substr(begin, scanner.position() - begin);
 }
 
 const char* getOutAttributePrefix(const enums::ShaderStageBit preStage)
@@ -120,26 +371,47 @@ void ShaderPreprocessor::parseMainBlock(const String& source, PipelineBuildingCo
         return;
     }
 
-    CHECK_WARN(source.search(REGEX_IN_PATTERN, sanitizer), "Non-standard attribute declared above, move it into ark_main function's parameters will disable this warning.");
-
-    static const std::regex MAIN_ENTRY_PATTERN(R"(([ui]?vec4|void)\s+ark_main\(([^{]*)\)[\s\r\n]*\{)");
-
-    source.search(MAIN_ENTRY_PATTERN, [this] (const std::smatch& m)->bool {
-        const String prefix = m.prefix().str();
-        const String remaining = m.suffix().str();
-        String body;
-        const size_t prefixStart = parseFunctionBody(remaining, body);
-        sp<String> fragment = sp<String>::make();
-        _main_source.push_back(sp<String>::make(prefix + "\n"));
-        _main_source.push_back(fragment);
-        _main_source.push_back(sp<String>::make("\n" + remaining.substr(prefixStart)));
-
-        StringBuffer sEntryName;
-        for(const char c : this->_resid.str())
-            sEntryName << (std::isalnum(c) ? c : '_');
-        _main_entry = sp<MainEntry>::make(sEntryName.str(), m[2].str(), m[1].str(), body.strip(), std::move(fragment));
-        return false;
-    });
+    bool hasNonStandardAttribute = false;
+    GLSLScanner scanner(source);
+    for(StringView token = scanner.next(); !token.empty(); token = scanner.next())
+    {
+        const size_t begin = scanner.tokenBegin();
+        const size_t resume = scanner.position();
+        if(token == "attribute" || token == "varying" || token == "in")
+        {
+            if(const Optional<StringView> attribute = scanNonStandardAttribute(scanner, source, begin); attribute && !hasNonStandardAttribute)
+            {
+                WARN(String(attribute.value()).c_str());
+                hasNonStandardAttribute = true;
+            }
+        }
+        else if(!_main_entry && (token == "void" || token == "vec4" || token == "ivec4" || token == "uvec4") && scanner.accept("ark_main") && scanner.accept("("))
+        {
+            const StringView sourceView = source;
+            const size_t paramsBegin = scanner.position();
+            const size_t bodyBegin = sourceView.find('{', paramsBegin);
+            const size_t paramsEnd = bodyBegin == StringView::npos ? StringView::npos : sourceView.rfind(')', bodyBegin);
+            if(paramsEnd != StringView::npos && paramsEnd >= paramsBegin && sourceView.find_first_not_of(" \t\r\n", paramsEnd + 1) == bodyBegin)
+            {
+                const String remaining = sourceView.substr(bodyBegin + 1);
+                String body;
+                const size_t prefixStart = parseFunctionBody(remaining, body);
+                sp<String> fragment = sp<String>::make();
+                _main_source.push_back(sp<String>::make(String(sourceView.substr(0, begin)) + "\n"));
+                _main_source.push_back(fragment);
+                _main_source.push_back(sp<String>::make("\n" + remaining.substr(prefixStart)));
+
+                StringBuffer sEntryName;
+                for(const char c : this->_resid.str())
+                    sEntryName << (std::isalnum(c) ? c : '_');
+                _main_entry = sp<MainEntry>::make(sEntryName.str(), String(sourceView.substr(paramsBegin, paramsEnd - paramsBegin)), String(token), body.strip(), std::move(fragment));
+                scanner.seek(bodyBegin + 1);
+                continue;
+            }
+        }
+        scanner.seek(resume);
+    }
+    CHECK_WARN(!hasNonStandardAttribute, "Non-standard attribute declared above, move it into ark_main function's parameters will disable this warning.");
 
     DCHECK(_main_entry, "Parsing source error: \n%s\n Undefined ark_main in shader", source.c_str());
 
@@ -149,57 +421,30 @@ void ShaderPreprocessor::parseMainBlock(const String& source, PipelineBuildingCo
 void ShaderPreprocessor::parseDeclarations()
 {
     _predefined_macros.push_back(std::move(*makeIncludeSource("shaders/defines.h")));
-    _main_source.replace(REGEX_INCLUDE_PATTERN, [](const std::smatch& m) {
-        return makeIncludeSource(m[1].str());
-    });
-
-    const auto structPatternReplacer = [this](const std::smatch& m) {
-        const sp<String> declaration = sp<String>::make(m.str());
-        this->_struct_declaration_source.push_back(declaration);
-        this->_struct_definitions.push_back(m[1].str(), m[2].str());
-        return nullptr;
-    };
-    _main_source.replace(REGEX_STRUCT_PATTERN, structPatternReplacer);
-
-    const auto uniformPatternReplacer = [this](const std::smatch& m) {
-        const uint32_t length = m[5].matched ? Strings::eval<uint32_t>(m[5].str()) : 1;
-        const int32_t binding = m[1].matched ? Strings::eval<int32_t>(m[1].str()) : -1;
-        const int32_t set = m[2].matched ? Strings::eval<int32_t>(m[2].str()) : -1;
-        return this->addUniform(m[3].str(), m[4].str(), length, {binding, set}, m.str());
-    };
-    _main_source.replace(REGEX_UNIFORM_PATTERN, uniformPatternReplacer);
-
-    auto ssboPattern = [this](const std::smatch& m) {
-        const int32_t binding = m[1].matched ? Strings::eval<int32_t>(m[1].str()) : -1;
-        const int32_t set = m[2].matched ? Strings::eval<int32_t>(m[2].str()) : -1;
-        sp<String> declaration = sp<String>::make(m.str());
-        enums::ShaderTypeQualifier qualifier;
-        if(declaration->find(" readonly ") != String::npos)
-            qualifier.set(enums::SHADER_TYPE_QUALIFIER_READONLY, true);
-        if(declaration->find(" writeonly ") != String::npos)
-            qualifier.set(enums::SHADER_TYPE_QUALIFIER_WRITEONLY, true);
-        _ssbos[m[3].str()] = {{binding, set, qualifier}, declaration};
-        return declaration;
-    };
-    _main_source.replace(REGEX_SSBO_PATTERN, ssboPattern);
-
-    if(_shader_stage == enums::SHADER_STAGE_BIT_COMPUTE)
-    {
-        const auto localSizeTraveller = [this] (const std::smatch& m)
+    _main_source.replace([this](const Statement& statement) -> sp<String> {
+        switch(statement._type)
         {
-            _compute_local_sizes = {{1, 1, 1}};
-            V3i& localSizes = _compute_local_sizes.value();
-            for(const String& i : String(m[1].str()).split(','))
-                if(const auto [k, v] = i.cut('='); v)
-                {
-                    const uint32_t workGroup = k.strip().at(StringView("local_size_").size()) - 'x';
-                    const int32_t size = Strings::eval<int32_t>(v.value());
-                    localSizes[workGroup] = size;
-                }
-            return true;
-        };
-        _main_source.search(REGEX_LOCAL_SIZE_PATTERN, localSizeTraveller);
-    }
+            case Statement::STATEMENT_TYPE_INCLUDE:
+                return makeIncludeSource(statement._name);
+            case Statement::STATEMENT_TYPE_STRUCT:
+                this->_struct_declaration_source.push_back(sp<String>::make(statement._source));
+                this->_struct_definitions.push_back(statement._name, statement._declared_type);
+                return nullptr;
+            case Statement::STATEMENT_TYPE_UNIFORM:
+                return this->addUniform(statement._declared_type, statement._name, statement._length, {statement._binding._location, statement._binding._set}, statement._source);
+            case Statement::STATEMENT_TYPE_SSBO:
+            {
+                sp<String> declaration = sp<String>::make(statement._source);
+                _ssbos[statement._name] = {statement._binding, declaration};
+                return declaration;
+            }
+            case Statement::STATEMENT_TYPE_LOCAL_SIZE:
+                if(_shader_stage == enums::SHADER_STAGE_BIT_COMPUTE)
+                    _compute_local_sizes = statement._local_sizes;
+                return sp<String>::make(statement._source);
+        }
+        return nullptr;
+    });
 
     if(!_main_entry)
         return;
@@ -617,14 +862,6 @@ void ShaderPreprocessor::Source::push_back(sp<String> fragment)
     _lines.push_back(std::move(fragment));
 }
 
-bool ShaderPreprocessor::Source::search(const std::regex& pattern, const std::function<bool (const std::smatch&)>& traveller) const
-{
-    for(const sp<String>& i : _lines)
-        if(!i->search(pattern, traveller))
-            return false;
-    return true;
-}
-
 bool ShaderPreprocessor::Source::contains(const String& str) const
 {
     for(const sp<String>& i : _lines)
@@ -639,37 +876,21 @@ void ShaderPreprocessor::Source::replace(const String& str, const String& replac
         *i = i->replace(str, replacment);
 }
 
-void ShaderPreprocessor::Source::replace(const std::regex& regexp, const std::function<sp<String>(const std::smatch&)>& replacer)
+void ShaderPreprocessor::Source::replace(const std::function<sp<String>(const Statement&)>& replacer)
 {
     Vector<sp<String>> inserting;
-    for(auto iter = _lines.begin(); iter != _lines.end(); ++iter)
+    for(auto iter = _lines.begin(); iter != _lines.end(); )
     {
-        if((*iter)->strip().startsWith("//"))
-            continue;
-
-        bool matched = false;
         inserting.clear();
-        (*iter)->search(regexp, [&matched, &inserting, replacer](const std::smatch& match) {
-            if(sp<String> replacement = replacer(match))
-                inserting.push_back(std::move(replacement));
-            matched = true;
-            return true;
-        }, [&inserting](const String& unmatch) {
-            inserting.push_back(sp<String>::make(unmatch));
-            return true;
-        });
-
-        if(matched || inserting.size() > 1)
+        if(!replaceStatements(**iter, replacer, inserting, 0))
         {
-            for(const auto& i : inserting)
-            {
-                iter = _lines.insert(iter, i);
-                ++iter;
-            }
-            iter = _lines.erase(iter);
-            if(iter == _lines.end())
-                break;
+            ++ iter;
+            continue;
         }
+
+        for(sp<String>& i : inserting)
+            _lines.insert(iter, std::move(i));
+        iter = _lines.erase(iter);
     }
 }
 
@@ -62,6 +62,27 @@ public:
         sp<String> _declaration;
     };
 
+//  A declaration recognized while scanning the source, "_source" views the whole statement in the fragment it was found in.
+    struct Statement {
+        enum Type {
+            STATEMENT_TYPE_INCLUDE,
+            STATEMENT_TYPE_STRUCT,
+            STATEMENT_TYPE_UNIFORM,
+            STATEMENT_TYPE_SSBO,
+            STATEMENT_TYPE_LOCAL_SIZE
+        };
+
+        Type _type;
+        StringView _source;
+//  Include path, struct, uniform or SSBO block name.
+        StringView _name;
+//  Uniform type or struct body.
+        StringView _declared_type;
+        uint32_t _length = 1;
+        PipelineLayout::Binding _binding;
+        V3i _local_sizes = {1, 1, 1};
+    };
+
 private:
     class Source {
     public:
@@ -72,11 +93,11 @@ private:
 
         void push_back(sp<String> fragment);
 
-        bool search(const std::regex& pattern, const std::function<bool(const std::smatch& match)>& traveller) const;
         bool contains(const String& str) const;
 
         void replace(const String& str, const String& replacment);
-        void replace(const std::regex& regexp, const std::function<sp<String>(const std::smatch&)>& replacer);
+//  Scans every fragment once and splices in whatever "replacer" returns for each statement, nullptr drops it. Included sources get scanned in place.
+        void replace(const std::function<sp<String>(const Statement&)>& replacer);
 
         void insertBefore(const String& statement, const String& str);
 
@@ -1,5 +1,14 @@
 #include "renderer/base/texture_bundle.h"
 
+#include <atomic>
+#include <mutex>
+#include <ranges>
+
+#include "core/ark.h"
+#include "core/base/future.h"
+#include "core/inf/executor.h"
+#include "core/inf/runnable.h"
+#include "core/types/weak_ptr.h"
 #include "core/util/loader_bundle.h"
 
 #include "graphics/base/bitmap.h"
@@ -7,8 +16,12 @@
 
 #include "renderer/base/render_controller.h"
 #include "renderer/base/render_backend.h"
+#include "renderer/inf/recyclable.h"
 #include "renderer/inf/renderer_factory.h"
 
+#include "app/base/application_context.h"
+#include "app/base/application_manifest.h"
+
 namespace ark {
 
 namespace {
@@ -30,6 +43,145 @@ private:
     String _name;
 };
 
+class UploaderBitmapStreaming final : public Texture::Uploader {
+public:
+    UploaderBitmapStreaming(sp<BitmapLoaderBundle> bitmapLoader, String name, bitmap bitmapBounds)
+        : _bitmap_loader(std::move(bitmapLoader)), _name(std::move(name)), _bitmap_bounds(std::move(bitmapBounds)), _state(STATE_DECODING) {
+    }
+
+    void initialize(GraphicsContext& graphicContext, Texture::Delegate& delegate) override {
+        bitmap decoded;
+        {
+            const std::lock_guard guard(_mutex);
+            if(_state == STATE_DECODING) {
+//  Allocates the storage only, the texture stays blank until the decoded pixels get streamed in.
+                delegate.uploadBitmap(graphicContext, _bitmap_bounds, {nullptr});
+                return;
+            }
+            decoded = std::move(_decoded);
+            _state = STATE_UPLOADED;
+        }
+
+//  The decoded pixels are released once uploaded, so a lost surface decodes them again on the render thread.
+        if(!decoded)
+            decoded = _bitmap_loader->load(_name);
+        CHECK(decoded, "Texture resource \"%s\" not found", _name.c_str());
+        delegate.uploadBitmap(graphicContext, decoded, {decoded->byteArray()});
+    }
+
+//  [[ark::threadsafe]]
+    size_t decode() {
+        bitmap decoded = _bitmap_loader->load(_name);
+        CHECK(decoded, "Texture resource \"%s\" not found", _name.c_str());
+        const size_t byteSize = decoded->rowBytes() * decoded->height();
+        const std::lock_guard guard(_mutex);
+        _decoded = std::move(decoded);
+        _state = STATE_DECODED;
+        return byteSize;
+    }
+
+//  [[ark::threadsafe]]
+    bool isDecoded() {
+        const std::lock_guard guard(_mutex);
+        return _state == STATE_DECODED;
+    }
+
+private:
+    enum State {
+        STATE_DECODING,
+        STATE_DECODED,
+        STATE_UPLOADED
+    };
+
+    sp<BitmapLoaderBundle> _bitmap_loader;
+    String _name;
+    bitmap _bitmap_bounds;
+
+    std::mutex _mutex;
+    State _state;
+    bitmap _decoded;
+};
+
+}
+
+//  Raised by the bundle and read by the decode task and the render thread's streaming upload.
+class TextureBundle::TextureDropped final : public Boolean {
+public:
+    bool val() override {
+        return _dropped.load(std::memory_order_acquire);
+    }
+
+    bool update(uint32_t /*tick*/) override {
+        return true;
+    }
+
+    void drop() {
+        _dropped.store(true, std::memory_order_release);
+    }
+
+private:
+    std::atomic<bool> _dropped = false;
+};
+
+namespace {
+
+//  Textures are held weakly until uploaded, so a pending decode and upload never keeps one alive.
+class TextureStreaming final : public Resource {
+public:
+    TextureStreaming(WeakPtr<Texture> texture, sp<UploaderBitmapStreaming> uploader, sp<Boolean> dropped)
+        : _texture(std::move(texture)), _uploader(std::move(uploader)), _dropped(std::move(dropped)) {
+    }
+
+    uint64_t id() override {
+        const sp<Texture> texture = _texture.lock();
+        return texture ? texture->id() : 0;
+    }
+
+    void upload(GraphicsContext& graphicsContext) override {
+        if(!_uploader->isDecoded() || _dropped->val())
+            return;
+
+        const sp<Texture> texture = _texture.lock();
+        if(!texture)
+            return;
+        if(texture->id() != 0)
+            texture->toRecyclable();
+        texture->upload(graphicsContext);
+    }
+
+    op<Recyclable> toRecyclable() override {
+        const sp<Texture> texture = _texture.lock();
+        return texture ? texture->toRecyclable() : op<Recyclable>();
+    }
+
+private:
+    WeakPtr<Texture> _texture;
+    sp<UploaderBitmapStreaming> _uploader;
+    sp<Boolean> _dropped;
+};
+
+class DecodeTextureRunnable final : public Runnable {
+public:
+    DecodeTextureRunnable(sp<RenderController> renderController, WeakPtr<Texture> texture, sp<UploaderBitmapStreaming> uploader, sp<Boolean> dropped)
+        : _render_controller(std::move(renderController)), _texture(std::move(texture)), _uploader(std::move(uploader)), _dropped(std::move(dropped)) {
+    }
+
+    void run() override {
+        if(_dropped->val())
+            return;
+
+        const size_t byteSize = _uploader->decode();
+        sp<Future> future = sp<Future>::make(nullptr, _dropped);
+        _render_controller->uploadStreaming(sp<Resource>::make<TextureStreaming>(std::move(_texture), std::move(_uploader), std::move(_dropped)), byteSize, std::move(future));
+    }
+
+private:
+    sp<RenderController> _render_controller;
+    WeakPtr<Texture> _texture;
+    sp<UploaderBitmapStreaming> _uploader;
+    sp<Boolean> _dropped;
+};
+
 }
 
 TextureBundle::TextureBundle(const sp<RenderController>& renderController)
@@ -38,20 +190,39 @@ TextureBundle::TextureBundle(const sp<RenderController>& renderController)
 {
 }
 
+TextureBundle::~TextureBundle()
+{
+    for(const sp<TextureDropped>& i : _textures_dropped | std::views::values)
+        i->drop();
+}
+
 const sp<Texture>& TextureBundle::createTexture(const String& src, const sp<Texture::Parameters>& parameters)
 {
     sp<Texture>& texture = _textures[src];
     DCHECK_WARN(!texture, "Overriding Texture \"%s\"", src.c_str());
+    if(const auto iter = _textures_dropped.find(src); iter != _textures_dropped.end())
+    {
+        iter->second->drop();
+        _textures_dropped.erase(iter);
+    }
     texture = doCreateTexture(src, parameters);
     return texture;
 }
 
-sp<Texture> TextureBundle::doCreateTexture(const String& src, const sp<Texture::Parameters>& parameters) const
+sp<Texture> TextureBundle::doCreateTexture(const String& src, const sp<Texture::Parameters>& parameters)
 {
     const bitmap bitmapBounds = _bitmap_bounds_loader->load(src);
     DCHECK(bitmapBounds, "Texture resource \"%s\" not found", src.c_str());
     const sp<Size> size = sp<Size>::make(static_cast<float>(bitmapBounds->width()), static_cast<float>(bitmapBounds->height()));
-    return _render_controller->createTexture(size, parameters, sp<UploaderBitmapBundle>::make(_bitmap_loader, src));
+    if(Ark::instance().manifest()->renderer()._texture_upload_budget == 0)
+        return _render_controller->createTexture(size, parameters, sp<UploaderBitmapBundle>::make(_bitmap_loader, src));
+
+    sp<UploaderBitmapStreaming> uploader = sp<UploaderBitmapStreaming>::make(_bitmap_loader, src, bitmapBounds);
+    sp<Texture> texture = _render_controller->createTexture(size, parameters, uploader);
+    sp<TextureDropped> dropped = sp<TextureDropped>::make();
+    _textures_dropped.emplace(src, dropped);
+    Ark::instance().applicationContext()->threadPoolExecutor()->execute(sp<Runnable>::make<DecodeTextureRunnable>(_render_controller, texture, std::move(uploader), std::move(dropped)));
+    return texture;
 }
 
 }
@@ -13,11 +13,14 @@ namespace ark {
 class TextureBundle {
 public:
     TextureBundle(const sp<RenderController>& renderController);
+    ~TextureBundle();
 
     const sp<Texture>& createTexture(const String& src, const sp<Texture::Parameters>& parameters);
 
 private:
-    sp<Texture> doCreateTexture(const String& src, const sp<Texture::Parameters>& parameters) const;
+    class TextureDropped;
+
+    sp<Texture> doCreateTexture(const String& src, const sp<Texture::Parameters>& parameters);
 
 private:
     sp<RenderController> _render_controller;
@@ -26,6 +29,8 @@ private:
     sp<BitmapLoaderBundle> _bitmap_bounds_loader;
 
     std::map<String, sp<Texture>> _textures;
+//  Raised when the bundle lets go of a streamed texture, cancelling its pending decode and upload.
+    std::map<String, sp<TextureDropped>> _textures_dropped;
 };
 
 }
@@ -1,52 +1,18 @@
 #include "renderer/base/vertex_writer.h"
 
-#include "core/impl/writable/writable_memory.h"
-
-#include "graphics/base/v4.h"
-
 #include "renderer/base/model.h"
 
 namespace ark {
 
-class VertexWriter::WriterImpl final {
-public:
-    WriterImpl(sp<Writable> delegate, const uint32_t size, const uint32_t stride)
-        : _delegate(std::move(delegate)), _offset(0), _size(size), _stride(stride), _initialized(false)
-    {
-    }
-
-    void nextVertex()
-    {
-        if(_initialized)
-            _offset += _stride;
-        else
-            _initialized = true;
-        DCHECK(_offset <= _size - _stride, "Writer buffer out of bounds");
-    }
-
-    void write(const void* ptr, const uint32_t size, const uint32_t offset) const
-    {
-        DCHECK(_initialized, "Writer is uninitialized, call nextVertex() first");
-        DCHECK(size + offset <= _stride, "Stride overflow: sizeof(value) = %d, offset = %d", size, offset);
-        _delegate->write(ptr, size, _offset + offset);
-    }
-
-private:
-    sp<Writable> _delegate;
-    uint32_t _offset;
-    uint32_t _size;
-    uint32_t _stride;
-    bool _initialized;
-};
-
 VertexWriter::VertexWriter(const PipelineLayout::VertexDescriptor& attributes, const bool doTransform, const uint32_t size, const uint32_t stride, uint8_t* ptr)
-    : VertexWriter(attributes, doTransform, size, stride, sp<Writable>::make<WritableMemory>(ptr))
+    : _attribute_offsets(attributes), _stride(stride), _begin(ptr), _end(ptr + size), _vertex(nullptr), _transform_begin(ptr), _do_transform(doTransform), _visible(true),
+      _transform(nullptr), _transform_snapshot(nullptr)
 {
 }
 
-VertexWriter::VertexWriter(const PipelineLayout::VertexDescriptor& attributes, const bool doTransform, const uint32_t size, const uint32_t stride, sp<Writable> writer)
-    : _attribute_offsets(attributes), _delegate(sp<WriterImpl>::make(std::move(writer), size, stride)), _stride(stride), _do_transform(doTransform), _visible(true), _transform_snapshot(nullptr)
+VertexWriter::~VertexWriter()
 {
+    flush();
 }
 
 uint32_t VertexWriter::stride() const
@@ -59,13 +25,6 @@ bool VertexWriter::hasAttribute(const int32_t name) const
     return _attribute_offsets._offsets[name] >= 0;
 }
 
-void VertexWriter::writePosition(const V3 position)
-{
-    DASSERT(!_do_transform || _transform_snapshot);
-    const V3 obj = _visible ? (_do_transform ? (_transform->transform(*_transform_snapshot, {position, 1.0f}).toNonHomogeneous() + _translate) : position) : V3();
-    _delegate->write(&obj, sizeof(V3), 0);
-}
-
 void VertexWriter::writeTexCoordinate(const uint16_t u, const uint16_t v)
 {
     const uint16_t uv[2] = {u, v};
@@ -78,13 +37,9 @@ void VertexWriter::writeBoneInfo(const Mesh::BoneInfo& boneInfo)
     writeAttribute(boneInfo._weights, Attribute::USAGE_BONE_WEIGHTS);
 }
 
-void VertexWriter::write(const void* buf, const uint32_t size, const uint32_t offset)
-{
-    _delegate->write(buf, size, offset);
-}
-
 void VertexWriter::setRenderable(const Renderable::Snapshot& renderObject)
 {
+    flush();
     _transform = renderObject._transform.get();
     _transform_snapshot = &renderObject._transform_snapshot;
     _translate = renderObject._position;
@@ -107,15 +62,35 @@ void VertexWriter::writeBitangent(const V3 bitangent)
     writeAttribute(bitangent, Attribute::USAGE_BITANGENT);
 }
 
-void VertexWriter::next()
+VertexWriter VertexWriter::slice(const size_t offset, const size_t length) const
+{
+    DCHECK(_begin + (offset + length) * _stride <= _end, "Slice out of bounds");
+    return {_attribute_offsets, _do_transform, static_cast<uint32_t>(length * _stride), _stride, _begin + offset * _stride};
+}
+
+VertexWriter VertexWriter::rebind(uint8_t* ptr) const
+{
+    return {_attribute_offsets, _do_transform, static_cast<uint32_t>(_end - _begin), _stride, ptr};
+}
+
+const uint8_t* VertexWriter::data() const
 {
-    _delegate->nextVertex();
-    writeVaryings();
+    return _begin;
 }
 
-void VertexWriter::writeVaryings()
+size_t VertexWriter::size() const
 {
-    _delegate->write(_varying_contents.buf(), static_cast<uint32_t>(_varying_contents.length()), 0);
+    return _end - _begin;
+}
+
+void VertexWriter::flush()
+{
+    if(_vertex && _vertex >= _transform_begin && _do_transform && _visible && _transform)
+    {
+        const size_t count = (_vertex - _transform_begin) / _stride + 1;
+        _transform->transformPositions(*_transform_snapshot, _translate, _transform_begin, count, _stride);
+    }
+    _transform_begin = _vertex ? _vertex + _stride : _begin;
 }
 
 }
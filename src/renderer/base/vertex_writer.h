@@ -1,7 +1,8 @@
 #pragma once
 
+#include <string.h>
+
 #include "core/base/api.h"
-#include "core/inf/writable.h"
 
 #include "graphics/inf/transform.h"
 #include "graphics/inf/renderable.h"
@@ -11,43 +12,66 @@
 
 namespace ark {
 
+//  Writes interleaved vertices straight into a strip of memory. Positions are stored untransformed and every renderable's
+//  strip is transformed in one batch when the next renderable is set, on flush() or when the writer goes out of scope.
 class ARK_API VertexWriter {
 public:
-    VertexWriter(const PipelineLayout::VertexDescriptor& attributes, bool doTransform, uint32_t size, uint32_t stride, sp<Writable> writer);
     VertexWriter(const PipelineLayout::VertexDescriptor& attributes, bool doTransform, uint32_t size, uint32_t stride, uint8_t* ptr);
+    ~VertexWriter();
 
     template<typename T> void writeAttribute(const T& value, const Attribute::Usage usage) {
-        if(_attribute_offsets._offsets[usage] >= 0)
-            write(&value, sizeof(T), _attribute_offsets._offsets[usage]);
+        if(const int32_t offset = _attribute_offsets._offsets[usage]; offset >= 0)
+            write(&value, sizeof(T), static_cast<uint32_t>(offset));
     }
 
     uint32_t stride() const;
     bool hasAttribute(int32_t name) const;
 
-    void writePosition(V3 position);
+    void writePosition(const V3& position) {
+        DASSERT(!_do_transform || _transform_snapshot);
+        const V3 hidden;
+        write(_visible ? &position : &hidden, sizeof(V3), 0);
+    }
     void writeNormal(V3 normal);
     void writeTangent(V3 tangent);
     void writeBitangent(V3 bitangent);
     void writeTexCoordinate(uint16_t u, uint16_t v);
     void writeBoneInfo(const Mesh::BoneInfo& boneInfo);
 
-    void write(const void* buf, uint32_t size, uint32_t offset);
+    void write(const void* buf, const uint32_t size, const uint32_t offset) {
+        DCHECK(_vertex, "Writer is uninitialized, call next() first");
+        DCHECK(size + offset <= _stride, "Stride overflow: sizeof(value) = %d, offset = %d", size, offset);
+        memcpy(_vertex + offset, buf, size);
+    }
 
     void setRenderable(const Renderable::Snapshot& renderObject);
 
-    void next();
+    void next() {
+        _vertex = _vertex ? _vertex + _stride : _begin;
+        DCHECK(_vertex + _stride <= _end, "Writer buffer out of bounds");
+        if(const size_t length = _varying_contents.length())
+            memcpy(_vertex, _varying_contents.buf(), length);
+    }
 
-private:
-    void writeVaryings();
-    void writeArray(ByteArray& array);
+    void flush();
 
-private:
-    class WriterImpl;
+//  A writer over "length" vertices starting at vertex "offset" of this one. Slices of disjoint ranges can be filled concurrently.
+    VertexWriter slice(size_t offset, size_t length) const;
+//  A writer of the same layout and size over "ptr".
+    VertexWriter rebind(uint8_t* ptr) const;
+
+    const uint8_t* data() const;
+    size_t size() const;
 
+private:
     PipelineLayout::VertexDescriptor _attribute_offsets;
-    sp<WriterImpl> _delegate;
     uint32_t _stride;
 
+    uint8_t* _begin;
+    uint8_t* _end;
+    uint8_t* _vertex;
+    uint8_t* _transform_begin;
+
     bool _do_transform;
     bool _visible;
     Transform* _transform;
@@ -55,6 +79,8 @@ private:
     V3 _translate;
 
     ByteArray::View _varying_contents;
+
+    DISALLOW_COPY_AND_ASSIGN(VertexWriter);
 };
 
 }
@@ -1,5 +1,6 @@
 #include "renderer/components/varyings.h"
 
+#include <algorithm>
 #include <ranges>
 
 #include "core/base/allocator.h"
@@ -81,6 +82,43 @@ struct Varyings::SlotSnapshot {
     SlotSnapshot* _next = nullptr;
 };
 
+struct Varyings::Bindings {
+    struct Slot {
+        const String* _name;
+        const sp<Uploader>* _uploader;
+        uint32_t _divisor;
+        uint32_t _offset;
+    };
+
+    // Slots point into Varyings::_slots, whose nodes stay put until the Varyings is gone. Replacing an uploader keeps them valid, adding a slot bumps the revision.
+    Bindings(const PipelineLayout& pipelineLayout, const Map<String, sp<Uploader>>& slots, const uint32_t slotsRevision)
+        : _pipeline_layout_id(pipelineLayout.id()), _slots_revision(slotsRevision)
+    {
+        const HashMap<String, PipelineLayout::VaryingSlot>& varyingSlots = pipelineLayout.varyingSlots();
+        for(const auto& [name, uploader] : slots)
+        {
+            // A Varyings may be shared across shaders. A slot the current pipeline doesn't declare is
+            // simply not consumed by this shader (e.g. per-instance data used by the MRT pass but not
+            // the shadow-map pass), so skip it rather than treating it as an error. Re-enable the check
+            // below when a Varyings is bound to a single shader to catch misspelled varying names.
+            const auto iter = varyingSlots.find(name);
+            if(iter == varyingSlots.end())
+            {
+                // CHECK(false, "Varying has no attribute \"%s\". Did you mean \"%s\" in [%s]?", name.c_str(), findNearestAttribute(pipelineLayout, name).c_str(), getAllAttribute(pipelineLayout).c_str());
+                continue;
+            }
+            _slots.push_back({&name, &uploader, iter->second._divisor, iter->second._offset});
+        }
+        std::stable_sort(_slots.begin(), _slots.end(), [](const Slot& a, const Slot& b) {
+            return a._divisor < b._divisor;
+        });
+    }
+
+    uint32_t _pipeline_layout_id;
+    uint32_t _slots_revision;
+    Vector<Slot> _slots;
+};
+
 Varyings::Varyings(const Scope& kwargs)
 {
     for(const auto& [k, v] : kwargs.variables())
@@ -109,7 +147,7 @@ bool Varyings::update(const uint32_t timestamp)
 
 Box Varyings::getProperty(const String& name) const
 {
-    const auto iter = _properties.find(Strings::capitalizeFirst(name));
+    const auto iter = name.empty() || isupper(static_cast<unsigned char>(name.at(0))) ? _properties.find(name) : _properties.find(Strings::capitalizeFirst(name));
     CHECK(iter != _properties.end(), "Varyings has no property \"%s\"", name.c_str());
     return iter->second;
 }
@@ -123,7 +161,9 @@ void Varyings::setSlotUploader(const String& name, sp<Uploader> uploader)
 {
     if(const auto iter = _slots.find(name); iter == _slots.end())
     {
+        const std::lock_guard<std::mutex> guard(_bindings_mutex);
         _slots.emplace(name, std::move(uploader));
+        ++ _slots_revision;
     }
     else
     {
@@ -196,24 +236,20 @@ Varyings::Snapshot Varyings::snapshot(const PipelineLayout& pipelineLayout, Allo
 
     size_t idx = 0;
     for(const auto& [divisor, vertexLayout] : vertexLayouts)
-        new(&buffers.at(idx++)) Divided(divisor, allocator.sbrkSpan(vertexLayout.stride()));
+    {
+        ByteArray::View content = allocator.sbrkSpan(vertexLayout.stride());
+        memset(content.buf(), 0, content.length());
+        new(&buffers.at(idx++)) Divided(divisor, std::move(content));
+    }
 
-    const HashMap<String, PipelineLayout::VaryingSlot>& varyingSlots = pipelineLayout.varyingSlots();
-    for(const auto& [name, uploader] : _slots)
+    const sp<const Bindings> bindings = ensureBindings(pipelineLayout);
+    SlotSnapshot* tail = nullptr;
+    for(size_t i = 0; i < bindings->_slots.size(); ++i)
     {
-        // A Varyings may be shared across shaders. A slot the current pipeline doesn't declare is
-        // simply not consumed by this shader (e.g. per-instance data used by the MRT pass but not
-        // the shadow-map pass), so skip it rather than treating it as an error. Re-enable the check
-        // below when a Varyings is bound to a single shader to catch misspelled varying names.
-        const auto iter = varyingSlots.find(name);
-        if(iter == varyingSlots.end())
-        {
-            // CHECK(false, "Varying has no attribute \"%s\". Did you mean \"%s\" in [%s]?", name.c_str(), findNearestAttribute(pipelineLayout, name).c_str(), getAllAttribute(pipelineLayout).c_str());
-            continue;
-        }
-        const PipelineLayout::VaryingSlot& slot = iter->second;
+        const Bindings::Slot& slot = bindings->_slots[i];
         DASSERT(slot._divisor < buffers.length());
-        buffers.at(slot._divisor).addSnapshot(allocator, name, uploader, slot._offset);
+        const bool sameDivisor = i > 0 && bindings->_slots[i - 1]._divisor == slot._divisor;
+        tail = buffers.at(slot._divisor).addSnapshot(allocator, *slot._name, *slot._uploader, slot._offset, sameDivisor ? tail : nullptr);
     }
 
     Snapshot snapshot(buffers);
@@ -221,6 +257,22 @@ Varyings::Snapshot Varyings::snapshot(const PipelineLayout& pipelineLayout, Allo
     return snapshot;
 }
 
+sp<const Varyings::Bindings> Varyings::ensureBindings(const PipelineLayout& pipelineLayout)
+{
+    const std::lock_guard<std::mutex> guard(_bindings_mutex);
+    for(const sp<const Bindings>& i : _bindings)
+        if(i->_pipeline_layout_id == pipelineLayout.id() && i->_slots_revision == _slots_revision)
+            return i;
+
+    const uint32_t slotsRevision = _slots_revision;
+    std::erase_if(_bindings, [slotsRevision](const sp<const Bindings>& i) {
+        return i->_slots_revision != slotsRevision;
+    });
+    sp<const Bindings> bindings = sp<const Bindings>::make(pipelineLayout, _slots, slotsRevision);
+    _bindings.push_back(bindings);
+    return bindings;
+}
+
 Varyings::BUILDER::BUILDER(BeanFactory& factory, const document& manifest)
     : _uploader_builders(factory.makeBuilderListObject<UploaderBuilder>(manifest, "varying"))
 {
@@ -307,7 +359,7 @@ void Varyings::Divided::apply(const SlotSnapshot* slots)
     }
 }
 
-void Varyings::Divided::addSnapshot(Allocator& allocator, const String& name, const sp<Uploader>& uploader, const uint32_t offset)
+Varyings::SlotSnapshot* Varyings::Divided::addSnapshot(Allocator& allocator, const String& name, const sp<Uploader>& uploader, const uint32_t offset, SlotSnapshot* tail)
 {
     const uint32_t size = static_cast<uint32_t>(uploader->size());
     void* content = allocator.sbrk(size);
@@ -318,16 +370,11 @@ void Varyings::Divided::addSnapshot(Allocator& allocator, const String& name, co
     SlotSnapshot* slotSnapshot = new(allocator.sbrk(sizeof(SlotSnapshot))) SlotSnapshot{content, offset, size};
     DCHECK(slotSnapshot->_offset + slotSnapshot->_size <= _content.length(), "Varyings buffer(size = %zu) overflow while adding attribute \"%s\" offset = %d size = %d ", _content.length(), name.c_str(), slotSnapshot->_offset, slotSnapshot->_size);
 
-    if(!_slot_snapshot)
-    {
+    if(tail)
+        tail->_next = slotSnapshot;
+    else
         _slot_snapshot = slotSnapshot;
-        return;
-    }
-
-    SlotSnapshot* tail = _slot_snapshot;
-    while(tail->_next != nullptr)
-        tail = tail->_next;
-    tail->_next = slotSnapshot;
+    return slotSnapshot;
 }
 
 }
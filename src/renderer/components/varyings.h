@@ -1,5 +1,7 @@
 #pragma once
 
+#include <mutex>
+
 #include "core/forwarding.h"
 #include "core/base/api.h"
 #include "core/base/scope.h"
@@ -20,6 +22,7 @@ namespace ark {
 class ARK_API Varyings {
 private:
     struct SlotSnapshot;
+    struct Bindings;
 
 public:
     struct Divided {
@@ -29,7 +32,8 @@ public:
         explicit operator bool() const;
 
         void apply(const SlotSnapshot* slots = nullptr);
-        void addSnapshot(Allocator& allocator, const String& name, const sp<Uploader>& uploader, uint32_t offset);
+//  Appends after "tail", or becomes the head of the slot list if "tail" is nullptr. Returns the new tail.
+        SlotSnapshot* addSnapshot(Allocator& allocator, const String& name, const sp<Uploader>& uploader, uint32_t offset, SlotSnapshot* tail);
 
         uint32_t _divisor;
 
@@ -116,12 +120,15 @@ private:
     Varyings(Map<String, sp<Uploader>> slots);
 
     void setSlotUploader(const String& name, sp<Uploader> uploader);
+    sp<const Bindings> ensureBindings(const PipelineLayout& pipelineLayout);
 
     template<typename T, typename... Args> void addVaryingProperties(const String& name, const Box& value) {
         if(sp<Variable<T>> var = value.as<Variable<T>>()) {
             String cname = Strings::capitalizeFirst(name);
             _properties.emplace(cname, var);
+            const std::lock_guard<std::mutex> guard(_bindings_mutex);
             _slots.emplace(std::move(cname), sp<Uploader>::make<UploaderOfVariable<T>>(std::move(var)));
+            ++ _slots_revision;
             return;
         }
 
@@ -140,6 +147,13 @@ private:
 
     Timestamp _timestamp;
 
+    // Slots resolved against the PipelineLayouts this Varyings was snapshotted with, rebuilt when a slot gets added.
+    // Snapshots of a shared Varyings may run on several threads, so the list and the revision are only touched under "_bindings_mutex".
+    // It is held just long enough to look up one of a handful of entries.
+    uint32_t _slots_revision = 0;
+    std::mutex _bindings_mutex;
+    Vector<sp<const Bindings>> _bindings;
+
     friend class BUILDER;
 };
 
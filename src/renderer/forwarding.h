@@ -5,6 +5,7 @@
 namespace ark {
 
 class Animation;
+class AnimationEvaluator;
 class Atlas;
 class Attribute;
 class BitmapBundle;
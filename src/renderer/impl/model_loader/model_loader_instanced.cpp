@@ -0,0 +1,23 @@
+#include "renderer/impl/model_loader/model_loader_instanced.h"
+
+#include "renderer/base/model.h"
+#include "renderer/impl/render_command_composer/rcc_draw_elements_instanced_incremental.h"
+
+namespace ark {
+
+ModelLoaderInstanced::ModelLoaderInstanced(sp<Model> model, sp<Texture> texture)
+    : ModelLoader(enums::DRAW_MODE_TRIANGLES, std::move(texture)), _model(std::move(model))
+{
+}
+
+sp<DrawingContextComposer> ModelLoaderInstanced::makeRenderCommandComposer(const Shader& /*shader*/)
+{
+    return sp<DrawingContextComposer>::make<RCCDrawElementsInstancedIncremental>(*_model);
+}
+
+sp<Model> ModelLoaderInstanced::loadModel(int32_t /*type*/)
+{
+    return _model;
+}
+
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "core/types/shared_ptr.h"
+
+#include "renderer/inf/model_loader.h"
+
+namespace ark {
+
+//  Draws every renderable of the layer as an instance of one model, uploading only the instances of dirty elements.
+class ModelLoaderInstanced final : public ModelLoader {
+public:
+    ModelLoaderInstanced(sp<Model> model, sp<Texture> texture);
+
+    sp<DrawingContextComposer> makeRenderCommandComposer(const Shader& shader) override;
+    sp<Model> loadModel(int32_t type) override;
+
+private:
+    sp<Model> _model;
+};
+
+}
@@ -31,9 +31,11 @@ DrawingContext RCCDrawElements::compose(const RenderRequest& renderRequest, cons
     DrawingBuffer buf(snapshot._stub->_pipeline_bindings, snapshot._stub->_stride);
     if(snapshot.verticesDirty())
     {
-        VertexWriter writer = buf.makeVertexWriter(renderRequest, verticesCount * snapshot._elements.size(), 0);
-        for(const RenderLayerSnapshot::Element& i : snapshot._elements)
-            i._snapshot._model->writeRenderable(writer, i._snapshot);
+        const VertexWriter writer = buf.makeVertexWriter(renderRequest, verticesCount * snapshot._elements.size(), 0);
+        snapshot.writeElementChunks(writer, verticesCount, [&snapshot](VertexWriter& chunkWriter, const size_t begin, const size_t end) {
+            for(size_t i = begin; i < end; ++i)
+                snapshot._elements[i]._snapshot._model->writeRenderable(chunkWriter, snapshot._elements[i]._snapshot);
+        });
     }
     else
     {
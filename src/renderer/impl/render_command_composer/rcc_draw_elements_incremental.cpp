@@ -67,4 +67,9 @@ DrawingContext RCCDrawElementsIncremental::compose(const RenderRequest& renderRe
     return snapshot.toDrawingContext(renderRequest, buf.vertices().toSnapshot(vertices), _indices.snapshot(std::move(indexUploader)), snapshot._index_count, DrawingParams::DrawElements{0});
 }
 
+bool RCCDrawElementsIncremental::keepsElementSlots() const
+{
+    return true;
+}
+
 }
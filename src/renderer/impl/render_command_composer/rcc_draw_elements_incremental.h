@@ -13,6 +13,7 @@ public:
 
     sp<PipelineBindings> makePipelineBindings(const Shader& shader, RenderController& renderController, enums::DrawMode renderMode) override;
     DrawingContext compose(const RenderRequest& renderRequest, const RenderLayerSnapshot& snapshot) override;
+    bool keepsElementSlots() const override;
 
 private:
     Buffer _indices;
@@ -44,17 +44,19 @@ DrawingContext RCCDrawElementsInstanced::compose(const RenderRequest& renderRequ
     const size_t attributeStride = attributeOffsets._strides[1];
     const bool hasModelMatrix = attributeOffsets._offsets[Attribute::USAGE_MODEL_MATRIX] != -1;
 
-    VertexWriter writer = buf.makeDividedVertexWriter(renderRequest, snapshot._elements.size(), 0, 1);
-    for(const RenderLayerSnapshot::Element& i : snapshot._elements)
-    {
-        const Renderable::Snapshot& snapshot = i._snapshot;
-        writer.next();
-        if(hasModelMatrix)
-            writer.writeAttribute(MatrixUtil::translate({}, snapshot._position) * MatrixUtil::scale(snapshot._transform->toMatrix(snapshot._transform_snapshot), snapshot._size), Attribute::USAGE_MODEL_MATRIX);
-        ByteArray::View divided = snapshot._varyings_snapshot.getDivided(1)._content;
-        if(divided.length() > attributeStride)
-            writer.write(divided.buf() + attributeStride, divided.length() - attributeStride, attributeStride);
-    }
+    const VertexWriter writer = buf.makeDividedVertexWriter(renderRequest, snapshot._elements.size(), 0, 1);
+    snapshot.writeElementChunks(writer, 1, [&snapshot, attributeStride, hasModelMatrix](VertexWriter& chunkWriter, const size_t begin, const size_t end) {
+        for(size_t i = begin; i < end; ++i)
+        {
+            const Renderable::Snapshot& renderable = snapshot._elements[i]._snapshot;
+            chunkWriter.next();
+            if(hasModelMatrix)
+                chunkWriter.writeAttribute(MatrixUtil::translate({}, renderable._position) * MatrixUtil::scale(renderable._transform->toMatrix(renderable._transform_snapshot), renderable._size), Attribute::USAGE_MODEL_MATRIX);
+            ByteArray::View divided = renderable._varyings_snapshot.getDivided(1)._content;
+            if(divided.length() > attributeStride)
+                chunkWriter.write(divided.buf() + attributeStride, divided.length() - attributeStride, attributeStride);
+        }
+    });
 
     return snapshot.toDrawingContext(renderRequest, buf.vertices().toSnapshot(vertices), _indices.snapshot(), static_cast<uint32_t>(snapshot._elements.size()), DrawingParams::DrawElementsInstanced{0, static_cast<uint32_t>(_model.indexCount()), buf.toDividedBufferSnapshots()});
 }
@@ -0,0 +1,125 @@
+#include "renderer/impl/render_command_composer/rcc_draw_elements_instanced_incremental.h"
+
+#include "graphics/base/render_layer.h"
+#include "graphics/base/render_request.h"
+#include "graphics/util/matrix_util.h"
+
+#include "renderer/base/drawing_buffer.h"
+#include "renderer/base/drawing_context.h"
+#include "renderer/base/render_controller.h"
+#include "renderer/base/pipeline_bindings.h"
+#include "renderer/base/shader.h"
+#include "renderer/base/vertex_writer.h"
+#include "renderer/inf/model_loader.h"
+#include "renderer/inf/vertices.h"
+
+namespace ark {
+
+namespace {
+
+void writeInstance(VertexWriter& writer, const Renderable::Snapshot& renderable, const size_t attributeStride, const bool hasModelMatrix)
+{
+    writer.next();
+    if(hasModelMatrix)
+        writer.writeAttribute(MatrixUtil::translate({}, renderable._position) * MatrixUtil::scale(renderable._transform->toMatrix(renderable._transform_snapshot), renderable._size), Attribute::USAGE_MODEL_MATRIX);
+    ByteArray::View divided = renderable._varyings_snapshot.getDivided(1)._content;
+    if(divided.length() > attributeStride)
+        writer.write(divided.buf() + attributeStride, divided.length() - attributeStride, attributeStride);
+}
+
+}
+
+RCCDrawElementsInstancedIncremental::RCCDrawElementsInstancedIncremental(Model model)
+    : _model(std::move(model)), _instance_count(0), _instance_capacity(0)
+{
+}
+
+sp<PipelineBindings> RCCDrawElementsInstancedIncremental::makePipelineBindings(const Shader& shader, RenderController& renderController, enums::DrawMode renderMode)
+{
+    _indices = renderController.makeIndexBuffer({}, _model.indices());
+    return shader.makeBindings(renderController.makeVertexBuffer(), renderMode, enums::DRAW_PROCEDURE_DRAW_INSTANCED);
+}
+
+DrawingContext RCCDrawElementsInstancedIncremental::compose(const RenderRequest& renderRequest, const RenderLayerSnapshot& snapshot)
+{
+    const Buffer& vertices = snapshot._stub->_pipeline_bindings->vertices();
+
+    DrawingBuffer buf(snapshot._stub->_pipeline_bindings, snapshot._stub->_stride);
+    if(snapshot.verticesDirty())
+    {
+        VertexWriter writer = buf.makeVertexWriter(renderRequest, _model.vertices()->length(), 0);
+        const Model model = snapshot._stub->_model_loader->loadModel(0);
+        model.writeToStream(writer, V3(1.0f));
+    }
+
+    const PipelineLayout::VertexDescriptor& attributeOffsets = buf.pipelineBindings()->pipelineDescriptor()->vertexDescriptor();
+    const size_t attributeStride = attributeOffsets._strides[1];
+    const bool hasModelMatrix = attributeOffsets._offsets[Attribute::USAGE_MODEL_MATRIX] != -1;
+    const uint32_t instanceCount = static_cast<uint32_t>(snapshot._elements.size());
+
+    Vector<const RenderLayerSnapshot::Element*> relocated;
+    Vector<bool> occupied(instanceCount, false);
+    size_t dirtyCount = 0;
+    for(const RenderLayerSnapshot::Element& i : snapshot._elements)
+    {
+        if(const Optional<element_index_t>& slot = i._element_state._index; slot && slot.value() < instanceCount)
+            occupied[slot.value()] = true;
+        else
+            relocated.push_back(&i);
+        if(i._snapshot._state.contains(Renderable::RENDERABLE_STATE_DIRTY))
+            ++ dirtyCount;
+    }
+
+    size_t freeSlot = 0;
+    for(const RenderLayerSnapshot::Element* i : relocated)
+    {
+        while(occupied[freeSlot])
+            ++ freeSlot;
+        i->_element_state._index = static_cast<element_index_t>(freeSlot++);
+    }
+
+    const bool grown = instanceCount > _instance_capacity;
+    if(grown)
+        _instance_capacity = std::max<uint32_t>(instanceCount, _instance_capacity * 2);
+
+//  Elements that aren't DIRTY were snapshotted without their transforms and varyings, so the ones written anyway get a full snapshot here.
+    if(grown || snapshot.verticesDirty() || (dirtyCount + relocated.size()) * 2 > instanceCount)
+    {
+        Vector<const RenderLayerSnapshot::Element*> slots(instanceCount);
+        for(const RenderLayerSnapshot::Element& i : snapshot._elements)
+            slots[i._element_state._index.value()] = &i;
+
+        VertexWriter writer = buf.makeDividedVertexWriter(renderRequest, instanceCount, 0, 1);
+        for(const RenderLayerSnapshot::Element* i : slots)
+            writeInstance(writer, i->takeFullSnapshot(renderRequest, snapshot), attributeStride, hasModelMatrix);
+    }
+    else
+    {
+        for(const RenderLayerSnapshot::Element& i : snapshot._elements)
+            if(i._snapshot._state.contains(Renderable::RENDERABLE_STATE_DIRTY))
+            {
+                VertexWriter writer = buf.makeDividedVertexWriter(renderRequest, 1, i._element_state._index.value(), 1);
+                writeInstance(writer, i._snapshot, attributeStride, hasModelMatrix);
+            }
+        for(const RenderLayerSnapshot::Element* i : relocated)
+            if(!i->_snapshot._state.contains(Renderable::RENDERABLE_STATE_DIRTY))
+            {
+                VertexWriter writer = buf.makeDividedVertexWriter(renderRequest, 1, i->_element_state._index.value(), 1);
+                writeInstance(writer, i->takeFullSnapshot(renderRequest, snapshot), attributeStride, hasModelMatrix);
+            }
+    }
+
+    Buffer::SnapshotFactory& instances = buf.getDividedBufferBuilder(1);
+    if(!instances._strips.empty())
+        instances._size = _instance_capacity * instances._stride;
+    _instance_count = instanceCount;
+
+    return snapshot.toDrawingContext(renderRequest, buf.vertices().toSnapshot(vertices), _indices.snapshot(), instanceCount, DrawingParams::DrawElementsInstanced{0, static_cast<uint32_t>(_model.indexCount()), buf.toDividedBufferSnapshots()});
+}
+
+bool RCCDrawElementsInstancedIncremental::keepsElementSlots() const
+{
+    return true;
+}
+
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "renderer/forwarding.h"
+#include "renderer/base/buffer.h"
+#include "renderer/base/model.h"
+#include "renderer/inf/drawing_context_composer.h"
+
+namespace ark {
+
+//  Instanced composer that keeps each element in a stable instance slot and only re-uploads the slots of dirty elements.
+//  Slots stay dense in [0, instance count): discarded elements leave holes which are refilled from the tail.
+class RCCDrawElementsInstancedIncremental final : public DrawingContextComposer {
+public:
+    RCCDrawElementsInstancedIncremental(Model model);
+
+    sp<PipelineBindings> makePipelineBindings(const Shader& shader, RenderController& renderController, enums::DrawMode renderMode) override;
+    DrawingContext compose(const RenderRequest& renderRequest, const RenderLayerSnapshot& snapshot) override;
+    bool keepsElementSlots() const override;
+
+private:
+    Model _model;
+    Buffer _indices;
+
+    uint32_t _instance_count;
+    uint32_t _instance_capacity;
+};
+
+}
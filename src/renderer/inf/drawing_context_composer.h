@@ -12,6 +12,12 @@ public:
 
     virtual sp<PipelineBindings> makePipelineBindings(const Shader& shader, RenderController& renderController, enums::DrawMode renderMode) = 0;
     virtual DrawingContext compose(const RenderRequest& renderRequest, const RenderLayerSnapshot& snapshot) = 0;
+
+//  True if elements are written to the slots in their ElementState::_index rather than by their position in RenderLayerSnapshot::_elements.
+//  Such composers take elements in and out of a layer through NEW and _elements_deleted, without the whole layer being rewritten.
+    virtual bool keepsElementSlots() const {
+        return false;
+    }
 };
 
 }
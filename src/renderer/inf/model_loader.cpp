@@ -2,6 +2,7 @@
 
 #include "renderer/base/pipeline_bindings.h"
 #include "renderer/base/texture.h"
+#include "renderer/impl/model_loader/model_loader_instanced.h"
 #include "renderer/impl/model_loader/model_loader_nine_patch_quads.h"
 #include "renderer/impl/model_loader/model_loader_nine_patch_triangle_strips.h"
 #include "renderer/impl/model_loader/model_loader_quad.h"
@@ -54,4 +55,9 @@ sp<ModelLoader> ModelLoader::text(sp<Alphabet> alphabet, sp<Atlas> atlas, const
     return sp<ModelLoader>::make<ModelLoaderText>(std::move(alphabet), std::move(atlas), font);
 }
 
+sp<ModelLoader> ModelLoader::instanced(sp<Model> model, sp<Texture> texture)
+{
+    return sp<ModelLoader>::make<ModelLoaderInstanced>(std::move(model), std::move(texture));
+}
+
 }
@@ -49,6 +49,9 @@ public:
     [[nodiscard]]
 //  [[script::bindings::auto]]
     static sp<ModelLoader> text(sp<Alphabet> alphabet, sp<Atlas> atlas, const Font& font);
+    [[nodiscard]]
+//  [[script::bindings::auto]]
+    static sp<ModelLoader> instanced(sp<Model> model, sp<Texture> texture = nullptr);
 
 private:
     enums::DrawMode _render_mode;
@@ -1,16 +1,25 @@
 #include "renderer/util/render_util.h"
 
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <ranges>
+#include <thread>
 #include <glslang/Public/ShaderLang.h>
 #include <glslang/SPIRV/GlslangToSpv.h>
 
+#include "core/ark.h"
 #include "core/types/global.h"
 #include "core/types/shared_ptr.h"
+#include "core/util/log.h"
+#include "core/util/strings.h"
 #include "core/util/uploader_type.h"
 
 #include "renderer/base/model.h"
 #include "renderer/base/pipeline_building_context.h"
 
+#include "app/base/application_manifest.h"
+
 
 namespace ark {
 
@@ -232,6 +241,102 @@ glslang::EShTargetLanguageVersion toTargetLanguageVersion(const uint32_t targetL
     return defaultVersion;
 }
 
+//  On-disk cache of compiled SPIR-V, one "<key>.spv" file per shader. The key hashes everything that changes the output. Every file starts with a header
+//  followed by the full shader source, both checked again on load, so a hash collision or a file left behind by another compiler version reads as a miss
+//  instead of a wrong binary.
+class SPIRVCache {
+public:
+    SPIRVCache(const String& directory, const String& source, const enums::ShaderStageBit stage, const enums::RenderingBackendBit renderTarget, const uint32_t targetLanguageVersion)
+        : _directory(directory.c_str()), _source(source) {
+        const glslang::Version& glslangVersion = glslang::GetVersion();
+        const uint64_t salts[] = {FORMAT_VERSION, static_cast<uint64_t>(glslangVersion.major) << 32 | glslangVersion.minor, static_cast<uint64_t>(glslangVersion.patch),
+                                  static_cast<uint64_t>(stage), static_cast<uint64_t>(renderTarget), targetLanguageVersion, BUILD_TYPE};
+        _key = fnv1a(source.c_str(), source.length(), fnv1a(salts, sizeof(salts), FNV_OFFSET_BASIS));
+
+        char filename[32];
+        std::snprintf(filename, sizeof(filename), "%016llx.spv", static_cast<unsigned long long>(_key));
+        _filepath = _directory / filename;
+    }
+
+    Vector<uint32_t> load() const {
+        std::ifstream is(_filepath, std::ios::binary);
+        if(!is)
+            return {};
+
+        Header header;
+        if(!is.read(reinterpret_cast<char*>(&header), sizeof(header)) || header._magic != MAGIC || header._version != FORMAT_VERSION || header._key != _key || header._source_size != _source.length())
+            return {};
+
+        Vector<char> cachedSource(header._source_size);
+        if(!is.read(cachedSource.data(), static_cast<std::streamsize>(cachedSource.size())) || std::memcmp(cachedSource.data(), _source.c_str(), cachedSource.size()) != 0)
+            return {};
+
+        Vector<uint32_t> spirv(header._word_count);
+        if(!is.read(reinterpret_cast<char*>(spirv.data()), static_cast<std::streamsize>(spirv.size() * sizeof(uint32_t))))
+            return {};
+        return spirv;
+    }
+
+//  Writes to a temporary file first and renames it over the target, so concurrent compilers and interrupted runs never leave a torn binary behind.
+    void store(const Vector<uint32_t>& spirv) const {
+        std::error_code ec;
+        std::filesystem::create_directories(_directory, ec);
+
+        std::filesystem::path tmpPath = _filepath;
+        tmpPath += Strings::sprintf(".%zx.tmp", std::hash<std::thread::id>()(std::this_thread::get_id())).c_str();
+        {
+            std::ofstream os(tmpPath, std::ios::binary | std::ios::trunc);
+            const Header header = {MAGIC, FORMAT_VERSION, _key, static_cast<uint64_t>(_source.length()), static_cast<uint64_t>(spirv.size())};
+            if(!os.write(reinterpret_cast<const char*>(&header), sizeof(header)) || !os.write(_source.c_str(), static_cast<std::streamsize>(_source.length())) || !os.write(reinterpret_cast<const char*>(spirv.data()), static_cast<std::streamsize>(spirv.size() * sizeof(uint32_t))))
+            {
+                os.close();
+                std::filesystem::remove(tmpPath, ec);
+                LOGW("Cannot write SPIR-V cache file \"%s\"", tmpPath.string().c_str());
+                return;
+            }
+        }
+        std::filesystem::rename(tmpPath, _filepath, ec);
+        if(ec)
+        {
+            std::filesystem::remove(tmpPath, ec);
+            LOGW("Cannot write SPIR-V cache file \"%s\"", _filepath.string().c_str());
+        }
+    }
+
+private:
+    static constexpr uint32_t MAGIC = 0x56505341;
+//  Bump it whenever compileSPIR changes the way it drives glslang.
+    static constexpr uint32_t FORMAT_VERSION = 2;
+#ifdef ARK_FLAG_BUILD_TYPE
+    static constexpr uint64_t BUILD_TYPE = ARK_FLAG_BUILD_TYPE;
+#else
+    static constexpr uint64_t BUILD_TYPE = 0;
+#endif
+    static constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;
+    static constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+
+    struct Header {
+        uint32_t _magic;
+        uint32_t _version;
+        uint64_t _key;
+        uint64_t _source_size;
+        uint64_t _word_count;
+    };
+
+    static uint64_t fnv1a(const void* data, const size_t size, uint64_t hash) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for(size_t i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * FNV_PRIME;
+        return hash;
+    }
+
+private:
+    std::filesystem::path _directory;
+    std::filesystem::path _filepath;
+    String _source;
+    uint64_t _key;
+};
+
 }
 
 bytearray RenderUtil::makeUnitCubeVertices(const bool flipWindingOrder)
@@ -493,6 +598,14 @@ std::pair<int32_t, int32_t> RenderUtil::getRenderTargetResolution(const RenderTa
 
 Vector<uint32_t> RenderUtil::compileSPIR(const String& source, enums::ShaderStageBit stage, enums::RenderingBackendBit renderTarget, const uint32_t targetLanguageVersion)
 {
+    Optional<SPIRVCache> cache;
+    if(const String& cacheDirectory = Ark::instance().manifest()->renderer()._shader_cache; !cacheDirectory.empty())
+    {
+        cache = SPIRVCache(cacheDirectory, source, stage, renderTarget, targetLanguageVersion);
+        if(Vector<uint32_t> spirv = cache->load(); !spirv.empty())
+            return spirv;
+    }
+
     const Global<GLSLLangInitializer> initializer;
     const EShLanguage esStage = initializer->toShLanguage(stage);
     glslang::TShader shader(esStage);
@@ -564,6 +677,8 @@ Vector<uint32_t> RenderUtil::compileSPIR(const String& source, enums::ShaderStag
             spvOptions.validate = true;
 #endif
             glslang::GlslangToSpv(*intermedia, spirv, &logger, &spvOptions);
+            if(cache)
+                cache->store(spirv);
             return spirv;
         }
     }